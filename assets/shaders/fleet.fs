@@ -0,0 +1,27 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 InnerCoord;
+in vec2 OuterCoord;
+in vec2 OverlayCoord;
+
+// Cell sized, premultiplied layer images baked by the FleetRenderer, transparent around the edges
+uniform sampler2D innerImage;
+uniform sampler2D outerImage;
+uniform sampler2D overlayImage;
+uniform vec3 backgroundColor;
+
+void main()
+{
+    // All layers back to front in one pass, so each cell pixel is written once
+    vec4 layer = texture(innerImage, InnerCoord);
+    vec3 color = layer.rgb + backgroundColor * (1.0 - layer.a);
+
+    layer = texture(outerImage, OuterCoord);
+    color = layer.rgb + color * (1.0 - layer.a);
+
+    layer = texture(overlayImage, OverlayCoord);
+    color = layer.rgb + color * (1.0 - layer.a);
+
+    FragColor = vec4(color, 1.0);
+}
@@ -0,0 +1,34 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aTexCoord;
+
+// Per aircraft
+layout (location = 2) in vec3 aCell;     // origin.xy, size
+layout (location = 3) in vec2 aAttitude; // pitch, roll (degrees)
+
+out vec2 InnerCoord;
+out vec2 OuterCoord;
+out vec2 OverlayCoord;
+
+uniform mat4 projection;
+uniform float indicatorSize;  // Size the pitch offset (1px per degree) was designed for
+uniform float layerMargin;    // Transparent margin of the baked images, as a fraction of their size
+
+void main()
+{
+    // The quad covers the cell, the layers are rolled and offset in texture space instead
+    vec2 position = aCell.xy + aPos * aCell.z;
+    gl_Position = projection * vec4(position, 0.0, 1.0);
+
+    // Inverse of the roll applied to the inner and outer layers
+    float rollRadians = radians(aAttitude.y);
+    mat2 inverseRotation = mat2(cos(rollRadians), -sin(rollRadians), sin(rollRadians), cos(rollRadians));
+    vec2 outer = inverseRotation * (aTexCoord - 0.5) + 0.5;
+    vec2 inner = outer - vec2(0.0, aAttitude.x / indicatorSize);
+
+    // Baked images are stored bottom row first, inside their margin
+    float layerScale = 1.0 - 2.0 * layerMargin;
+    OuterCoord = vec2(outer.x, 1.0 - outer.y) * layerScale + layerMargin;
+    InnerCoord = vec2(inner.x, 1.0 - inner.y) * layerScale + layerMargin;
+    OverlayCoord = vec2(aTexCoord.x, 1.0 - aTexCoord.y) * layerScale + layerMargin;
+}
@@ -0,0 +1,645 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <stb/stb_image.h>
+
+#include "renderer/shader.h"
+#include "renderer/sprite_renderer.h"
+#include "renderer/texture.h"
+#include "renderer/framebuffer.h"
+#include "renderer/fleet_renderer.h"
+#include "system/flight_recorder.h"
+#include "indicator/attitude_indicator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*
+* Golden image and hot path regression bench
+*
+* Renders a fixed grid of attitudes offscreen, compares each frame against the
+* reference images in BENCH_REFERENCE_DIR, reads back black box recordings and
+* times the renderer hot paths against absolute budgets and the medians committed
+* in BENCH_BASELINE_FILE. Built as indicator_tests with BENCH_GOLDEN_ONLY,
+* nothing is timed.
+* Results are written as JSON. Exit code 0 = pass, 1 = regression, 2 = setup error
+* (including missing reference images or baseline).
+*/
+#define BENCH_CANVAS_SIZE 200
+#define BENCH_INDICATOR_PX 175 // Keeps the committed reference images small
+#define BENCH_FLEET_AIRCRAFT 512
+#define BENCH_FLEET_WIDTH 1440 // Fleet canvas of a 1920x1080 window, every aircraft is on screen
+#define BENCH_FLEET_HEIGHT 1080
+#define BENCH_FLEET_BUDGET_US 16600.0 // 512 aircraft at 60 Hz
+#define BENCH_RECORDER_RECORDS (3 * RECORDER_BLOCK_RECORDS - 100) // Two full blocks and a partial one
+#define BENCH_RECORDER_APPEND_BUDGET_US 1.0
+
+static const float BENCH_PITCHES[] = { -40.0f, -20.0f, 0.0f, 20.0f, 40.0f };
+static const float BENCH_ROLLS[] = { -90.0f, -45.0f, 0.0f, 45.0f, 90.0f };
+
+struct BenchOptions {
+    std::string referenceDir = BENCH_REFERENCE_DIR;
+    std::string jsonPath;               // stdout when empty
+    bool updateReferences = false;
+    int channelTolerance = 8;           // Max per-channel difference before a pixel counts as bad
+    double maxBadPixelRatio = 0.002;    // Fraction of bad pixels allowed per image
+    int iterations = 200;
+    int rounds = 5;                     // Interleaved rounds the iterations are split into
+    std::string baselinePath = BENCH_BASELINE_FILE;
+    bool updateBaseline = false;
+    double baselineTolerance = 0.75;    // Fraction a median may exceed its baseline, loaded CI hosts vary by half
+    // Median microseconds allowed per hot path
+    std::map<std::string, double> budgets = { { "fleet_render", BENCH_FLEET_BUDGET_US },
+                                              { "recorder_append", BENCH_RECORDER_APPEND_BUDGET_US } };
+};
+
+struct GoldenResult {
+    std::string name;
+    float pitch, roll;
+    std::string status; // pass, fail, missing or updated
+    int maxError = 0;
+    double meanError = 0.0;
+    double badPixelRatio = 0.0;
+};
+
+struct CheckResult {
+    std::string name;
+    bool passed;
+    std::string detail;
+};
+
+struct TimingResult {
+    std::string name;
+    int iterations;
+    double minUs, medianUs, meanUs, p95Us;
+    double budgetUs = -1.0; // Negative when no budget was given
+    bool withinBudget = true;
+    double baselineUs = -1.0; // Negative when the path has no baseline
+    bool withinBaseline = true;
+};
+
+/*
+* Timing
+*
+* Hot paths are timed in rounds, interleaved with each other, so a burst of
+* load on the host slows one round of every path instead of all of one path.
+* The median reported and compared is the lowest round median, the other
+* figures cover every sample.
+*/
+struct HotPath {
+    std::string name;
+    int iterations;
+    int batch;                  // Calls per sample, for paths too short to time alone
+    std::function<void()> run;
+};
+
+static std::vector<TimingResult> timeHotPaths(const std::vector<HotPath>& paths, int rounds) {
+    std::vector<std::vector<double>> samples(paths.size());
+    std::vector<double> bestMedians(paths.size(), std::numeric_limits<double>::max());
+
+    std::vector<double> roundSamples;
+    for (int round = 0; round < rounds; ++round) {
+        for (size_t p = 0; p < paths.size(); ++p) {
+            const HotPath& path = paths[p];
+            int iterations = std::max(1, path.iterations / rounds);
+
+            roundSamples.clear();
+            for (int i = 0; i < iterations; ++i) {
+                auto start = std::chrono::steady_clock::now();
+                for (int j = 0; j < path.batch; ++j) {
+                    path.run();
+                }
+                auto end = std::chrono::steady_clock::now();
+                roundSamples.push_back(std::chrono::duration<double, std::micro>(end - start).count() / path.batch);
+            }
+
+            std::sort(roundSamples.begin(), roundSamples.end());
+            bestMedians[p] = std::min(bestMedians[p], roundSamples[roundSamples.size() / 2]);
+            samples[p].insert(samples[p].end(), roundSamples.begin(), roundSamples.end());
+        }
+    }
+
+    std::vector<TimingResult> results;
+    for (size_t p = 0; p < paths.size(); ++p) {
+        std::vector<double>& pathSamples = samples[p];
+        std::sort(pathSamples.begin(), pathSamples.end());
+        double total = 0.0;
+        for (double sample : pathSamples) {
+            total += sample;
+        }
+
+        TimingResult result;
+        result.name = paths[p].name;
+        result.iterations = (int)pathSamples.size();
+        result.minUs = pathSamples.front();
+        result.medianUs = bestMedians[p];
+        result.meanUs = total / pathSamples.size();
+        result.p95Us = pathSamples[std::min(pathSamples.size() - 1, (size_t)(pathSamples.size() * 0.95))];
+        results.push_back(result);
+    }
+    return results;
+}
+
+/*
+* Reference images (binary PPM, readable by stb_image)
+*/
+static bool writeReference(const std::string& path, const std::vector<unsigned char>& pixels, int width, int height) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "ERROR::BENCH::REFERENCE_NOT_WRITTEN: " << path << "\n";
+        return false;
+    }
+
+    file << "P6\n" << width << " " << height << "\n255\n";
+    file.write((const char*)pixels.data(), pixels.size());
+    return file.good();
+}
+
+static void compareReference(GoldenResult& result, const std::string& path, const std::vector<unsigned char>& pixels,
+                             int width, int height, const BenchOptions& options) {
+    int refWidth, refHeight, refChannels;
+    unsigned char* reference = stbi_load(path.c_str(), &refWidth, &refHeight, &refChannels, 3);
+    if (!reference) {
+        result.status = "missing";
+        return;
+    }
+
+    if (refWidth != width || refHeight != height) {
+        stbi_image_free(reference);
+        result.status = "fail";
+        result.badPixelRatio = 1.0;
+        return;
+    }
+
+    long long totalError = 0;
+    size_t badPixels = 0;
+    size_t pixelCount = (size_t)width * height;
+    for (size_t i = 0; i < pixelCount; ++i) {
+        int pixelError = 0;
+        for (int c = 0; c < 3; ++c) {
+            int diff = std::abs((int)pixels[i * 3 + c] - (int)reference[i * 3 + c]);
+            pixelError = std::max(pixelError, diff);
+            totalError += diff;
+        }
+
+        result.maxError = std::max(result.maxError, pixelError);
+        if (pixelError > options.channelTolerance) {
+            badPixels++;
+        }
+    }
+    stbi_image_free(reference);
+
+    result.meanError = (double)totalError / (pixelCount * 3);
+    result.badPixelRatio = (double)badPixels / pixelCount;
+    result.status = result.badPixelRatio <= options.maxBadPixelRatio ? "pass" : "fail";
+}
+
+/*
+* Baseline, one "<hot path> <median us>" line each
+*/
+static bool readBaseline(const std::string& path, std::map<std::string, double>& baseline) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string name;
+        double medianUs;
+        if (line.empty() || line[0] == '#' || !(fields >> name >> medianUs)) {
+            continue;
+        }
+        baseline[name] = medianUs;
+    }
+    return true;
+}
+
+static bool writeBaseline(const std::string& path, const std::vector<TimingResult>& timings) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "ERROR::BENCH::BASELINE_NOT_WRITTEN: " << path << "\n";
+        return false;
+    }
+
+    file << "# Hot path medians in microseconds, written by indicator_bench --update-baseline\n";
+    file << "# Renderer: " << (const char*)glGetString(GL_RENDERER) << "\n";
+    for (const TimingResult& timing : timings) {
+        file << timing.name << " " << timing.medianUs << "\n";
+    }
+    return file.good();
+}
+
+/*
+* Black box readback
+*/
+static bool flipByte(const std::string& path, long offset) {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    char byte;
+    file.seekg(offset);
+    file.read(&byte, 1);
+    byte = (char)~byte;
+    file.seekp(offset);
+    file.write(&byte, 1);
+    return file.good();
+}
+
+static void checkRecorder(std::vector<CheckResult>& checks) {
+    std::filesystem::path recordDir = std::filesystem::temp_directory_path() / "indicator_bench_readback";
+    std::error_code error;
+    std::filesystem::remove_all(recordDir, error);
+
+    // Appended before the writer starts, so stopping commits them all as consecutive blocks
+    {
+        FlightRecorder recorder(recordDir.string(), BENCH_RECORDER_RECORDS);
+        for (int i = 0; i < BENCH_RECORDER_RECORDS; ++i) {
+            FlightRecord record = {};
+            record.frameIndex = i;
+            record.pitch = (float)(i % 90);
+            recorder.append(record);
+        }
+        recorder.start();
+        recorder.stop();
+    }
+
+    std::string path;
+    for (const auto& entry : std::filesystem::directory_iterator(recordDir, error)) {
+        path = entry.path().string();
+    }
+
+    std::vector<FlightRecord> records;
+    size_t blocks = path.empty() ? 0 : readFlightFile(path, records);
+    bool ordered = records.size() == BENCH_RECORDER_RECORDS;
+    for (size_t i = 0; ordered && i < records.size(); ++i) {
+        ordered = records[i].frameIndex == i && records[i].pitch == (float)(i % 90);
+    }
+    checks.push_back({ "recorder_readback", blocks == 3 && ordered,
+                       std::to_string(records.size()) + " records in " + std::to_string(blocks) + " blocks" });
+
+    // Damage the second block, the scan keeps the first one only
+    long secondBlock = (long)(sizeof(FlightBlockHeader) + RECORDER_BLOCK_RECORDS * sizeof(FlightRecord));
+    std::string damaged = (recordDir / "damaged.rec").string();
+    std::filesystem::copy_file(path, damaged, error);
+    flipByte(damaged, secondBlock + (long)sizeof(FlightBlockHeader) + 5);
+    records.clear();
+    blocks = readFlightFile(damaged, records);
+    checks.push_back({ "recorder_corrupted_block", blocks == 1 && records.size() == RECORDER_BLOCK_RECORDS,
+                       std::to_string(blocks) + " blocks before the corrupted one" });
+
+    // A crash in the middle of the second write leaves it torn
+    std::string torn = (recordDir / "torn.rec").string();
+    std::filesystem::copy_file(path, torn, error);
+    std::filesystem::resize_file(torn, secondBlock + sizeof(FlightBlockHeader) + 100, error);
+    records.clear();
+    blocks = readFlightFile(torn, records);
+    checks.push_back({ "recorder_torn_block", blocks == 1 && records.size() == RECORDER_BLOCK_RECORDS,
+                       std::to_string(blocks) + " blocks before the torn one" });
+
+    std::filesystem::remove_all(recordDir, error);
+}
+
+/*
+* JSON output
+*/
+static void writeJson(std::ostream& out, const std::vector<GoldenResult>& golden, const std::vector<CheckResult>& checks,
+                      const std::vector<TimingResult>& timings, int rounds, bool passed) {
+    out << "{\n";
+    out << "  \"canvas\": [" << BENCH_CANVAS_SIZE << ", " << BENCH_CANVAS_SIZE << "],\n";
+    out << "  \"renderer\": \"" << (const char*)glGetString(GL_RENDERER) << "\",\n";
+    out << "  \"passed\": " << (passed ? "true" : "false") << ",\n";
+    out << "  \"rounds\": " << rounds << ",\n";
+
+    out << "  \"golden\": [\n";
+    for (size_t i = 0; i < golden.size(); ++i) {
+        const GoldenResult& g = golden[i];
+        out << "    {\"name\": \"" << g.name << "\", \"pitch\": " << g.pitch << ", \"roll\": " << g.roll
+            << ", \"status\": \"" << g.status << "\", \"max_error\": " << g.maxError
+            << ", \"mean_error\": " << g.meanError << ", \"bad_pixel_ratio\": " << g.badPixelRatio << "}"
+            << (i + 1 < golden.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n";
+
+    out << "  \"checks\": [\n";
+    for (size_t i = 0; i < checks.size(); ++i) {
+        const CheckResult& c = checks[i];
+        out << "    {\"name\": \"" << c.name << "\", \"status\": \"" << (c.passed ? "pass" : "fail")
+            << "\", \"detail\": \"" << c.detail << "\"}" << (i + 1 < checks.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n";
+
+    out << "  \"timings\": [\n";
+    for (size_t i = 0; i < timings.size(); ++i) {
+        const TimingResult& t = timings[i];
+        out << "    {\"name\": \"" << t.name << "\", \"iterations\": " << t.iterations
+            << ", \"min_us\": " << t.minUs << ", \"median_us\": " << t.medianUs
+            << ", \"mean_us\": " << t.meanUs << ", \"p95_us\": " << t.p95Us;
+        if (t.budgetUs >= 0.0) {
+            out << ", \"budget_us\": " << t.budgetUs << ", \"within_budget\": " << (t.withinBudget ? "true" : "false");
+        }
+        if (t.baselineUs >= 0.0) {
+            out << ", \"baseline_us\": " << t.baselineUs << ", \"within_baseline\": " << (t.withinBaseline ? "true" : "false");
+        }
+        out << "}" << (i + 1 < timings.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+/*
+* Command line
+*/
+static void printUsage() {
+    std::cerr << "Usage: indicator_bench [options]\n"
+              << "  --update-references     Rewrite the reference images instead of comparing\n"
+              << "  --reference-dir <dir>   Reference image directory (default: " << BENCH_REFERENCE_DIR << ")\n"
+              << "  --json <file>           Write results to file instead of stdout\n"
+              << "  --tolerance <n>         Per-channel difference allowed per pixel (default: 8)\n"
+              << "  --max-bad-pixels <r>    Fraction of pixels allowed over tolerance (default: 0.002)\n"
+              << "  --iterations <n>        Samples per hot path (default: 200)\n"
+              << "  --rounds <n>            Interleaved rounds the samples are split into, the lowest\n"
+              << "                          round median is reported (default: 5)\n"
+              << "  --baseline <file>       Committed hot path medians (default: " << BENCH_BASELINE_FILE << ")\n"
+              << "  --baseline-tolerance <r> Fraction a median may exceed its baseline (default: 0.75)\n"
+              << "  --update-baseline       Rewrite the baseline with this run's medians instead of comparing\n"
+              << "  --budget <name>=<us>    Fail when the median of a hot path exceeds the budget\n"
+              << "                          (default: fleet_render=" << BENCH_FLEET_BUDGET_US
+              << ", recorder_append=" << BENCH_RECORDER_APPEND_BUDGET_US << ")\n";
+}
+
+static bool parseArgs(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--update-references") {
+            options.updateReferences = true;
+        } else if (arg == "--reference-dir" && hasValue) {
+            options.referenceDir = argv[++i];
+            if (!options.referenceDir.empty() && options.referenceDir.back() != '/') {
+                options.referenceDir += '/';
+            }
+        } else if (arg == "--json" && hasValue) {
+            options.jsonPath = argv[++i];
+        } else if (arg == "--tolerance" && hasValue) {
+            options.channelTolerance = std::atoi(argv[++i]);
+        } else if (arg == "--max-bad-pixels" && hasValue) {
+            options.maxBadPixelRatio = std::atof(argv[++i]);
+        } else if (arg == "--iterations" && hasValue) {
+            options.iterations = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--rounds" && hasValue) {
+            options.rounds = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--baseline" && hasValue) {
+            options.baselinePath = argv[++i];
+        } else if (arg == "--baseline-tolerance" && hasValue) {
+            options.baselineTolerance = std::atof(argv[++i]);
+        } else if (arg == "--update-baseline") {
+            options.updateBaseline = true;
+        } else if (arg == "--budget" && hasValue) {
+            std::string budget = argv[++i];
+            size_t split = budget.find('=');
+            if (split == std::string::npos) {
+                return false;
+            }
+            options.budgets[budget.substr(0, split)] = std::atof(budget.c_str() + split + 1);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+static GLFWwindow* createHiddenContext() {
+    if (!glfwInit()) {
+        std::cerr << "Failed to initialize GLFW" << "\n";
+        return nullptr;
+    }
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    GLFWwindow* window = glfwCreateWindow(BENCH_CANVAS_SIZE, BENCH_CANVAS_SIZE, "indicator_bench", NULL, NULL);
+    if (!window) {
+        std::cerr << "Failed to create GLFW window" << "\n";
+        glfwTerminate();
+        return nullptr;
+    }
+
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        std::cerr << "Failed to initialize GLAD" << "\n";
+        glfwTerminate();
+        return nullptr;
+    }
+
+    return window;
+}
+
+static int runBench(const BenchOptions& options) {
+    Shader spriteShader(ASSET_DIR "shaders/sprite.vs", ASSET_DIR "shaders/sprite.fs");
+    SpriteRenderer spriteRenderer(spriteShader, BENCH_CANVAS_SIZE, BENCH_CANVAS_SIZE);
+    AttitudeSprites attitudeSprites = initAttitudeSprites(spriteRenderer, BENCH_CANVAS_SIZE, BENCH_CANVAS_SIZE, BENCH_INDICATOR_PX);
+
+    Framebuffer canvas(BENCH_CANVAS_SIZE, BENCH_CANVAS_SIZE);
+    canvas.bind();
+    glClearColor(0.10f, 0.10f, 0.12f, 1.0f);
+
+    bool passed = true;
+    int missingReferences = 0;
+
+    // Golden images
+    std::vector<GoldenResult> golden;
+    std::vector<unsigned char> pixels;
+    for (float pitch : BENCH_PITCHES) {
+        for (float roll : BENCH_ROLLS) {
+            GoldenResult result;
+            result.name = "pitch_" + std::to_string((int)pitch) + "_roll_" + std::to_string((int)roll);
+            result.pitch = pitch;
+            result.roll = roll;
+
+            updateAttitudeSprites(attitudeSprites, pitch, roll, true);
+            spriteRenderer.render();
+            canvas.readPixels(pixels);
+
+            std::string path = options.referenceDir + result.name + ".ppm";
+            if (options.updateReferences) {
+                result.status = writeReference(path, pixels, BENCH_CANVAS_SIZE, BENCH_CANVAS_SIZE) ? "updated" : "fail";
+            } else {
+                compareReference(result, path, pixels, BENCH_CANVAS_SIZE, BENCH_CANVAS_SIZE, options);
+            }
+
+            if (result.status == "missing") {
+                missingReferences++;
+            } else {
+                passed = passed && (result.status == "pass" || result.status == "updated");
+            }
+            golden.push_back(result);
+        }
+    }
+
+    // A missing reference is a setup problem, not a visual regression
+    if (missingReferences > 0) {
+        std::cerr << "ERROR::BENCH::REFERENCE_MISSING: " << missingReferences << " reference images not found in "
+                  << options.referenceDir << ", generate them with --update-references" << "\n";
+        passed = false;
+    }
+
+    // Black box recordings survive a torn or corrupted block
+    std::vector<CheckResult> checks;
+    checkRecorder(checks);
+    for (const CheckResult& check : checks) {
+        passed = passed && check.passed;
+    }
+
+    // Hot paths
+    std::vector<TimingResult> timings;
+    bool baselineError = false;
+#ifndef BENCH_GOLDEN_ONLY
+    int slowIterations = std::max(1, options.iterations / 20);
+    std::vector<HotPath> paths;
+
+    paths.push_back({ "texture_load", slowIterations, 1, [] {
+        Texture texture(ASSET_DIR "inner.png");
+        glFinish();
+    } });
+
+    paths.push_back({ "shader_create", slowIterations, 1, [] {
+        Shader shader(ASSET_DIR "shaders/sprite.vs", ASSET_DIR "shaders/sprite.fs");
+        glFinish();
+    } });
+
+    float frameRoll = 0.0f;
+    paths.push_back({ "frame_render", options.iterations, 1, [&] {
+        frameRoll = frameRoll >= 90.0f ? -90.0f : frameRoll + 1.0f;
+        updateAttitudeSprites(attitudeSprites, 10.0f, frameRoll, true);
+        canvas.bind();
+        spriteRenderer.render();
+        glFinish();
+    } });
+
+    volatile float sink = 0.0f;
+    float mathRoll = 0.0f;
+    paths.push_back({ "transform_math", options.iterations, 1000, [&] {
+        mathRoll = mathRoll >= 90.0f ? -90.0f : mathRoll + 0.5f;
+        updateAttitudeSprites(attitudeSprites, 10.0f, mathRoll, true);
+        for (const auto& sprite : attitudeSprites.sprites) {
+            sink = sink + sprite->transform.modelMatrix()[3][0];
+        }
+    } });
+
+    // Black box append with the writer thread draining to disk
+    std::filesystem::path recordDir = std::filesystem::temp_directory_path() / "indicator_bench_recordings";
+    FlightRecorder recorder(recordDir.string(), 1 << 16);
+    recorder.start();
+    FlightRecord record = {};
+    paths.push_back({ "recorder_append", options.iterations, 100, [&] {
+        record.frameIndex++;
+        recorder.append(record);
+    } });
+
+    // Worst case fleet frame: every aircraft on screen changed
+    Shader fleetShader(ASSET_DIR "shaders/fleet.vs", ASSET_DIR "shaders/fleet.fs");
+    FleetRenderer fleet(fleetShader, BENCH_FLEET_AIRCRAFT, BENCH_FLEET_WIDTH, BENCH_FLEET_HEIGHT);
+    float fleetRoll = 0.0f;
+    paths.push_back({ "fleet_render", options.iterations, 1, [&] {
+        fleetRoll = fleetRoll >= 90.0f ? -90.0f : fleetRoll + 1.0f;
+        for (int i = 0; i < BENCH_FLEET_AIRCRAFT; ++i) {
+            fleet.setAttitude(i, 10.0f, fleetRoll + i);
+        }
+        fleet.render();
+        glFinish();
+    } });
+
+    timings = timeHotPaths(paths, options.rounds);
+    canvas.unbind();
+
+    recorder.stop();
+    std::error_code error;
+    std::filesystem::remove_all(recordDir, error);
+
+    // Absolute budgets, then the committed baseline
+    for (TimingResult& timing : timings) {
+        auto budget = options.budgets.find(timing.name);
+        if (budget != options.budgets.end()) {
+            timing.budgetUs = budget->second;
+            timing.withinBudget = timing.medianUs <= budget->second;
+            passed = passed && timing.withinBudget;
+        }
+    }
+
+    if (options.updateBaseline) {
+        baselineError = !writeBaseline(options.baselinePath, timings);
+    } else {
+        std::map<std::string, double> baseline;
+        if (!readBaseline(options.baselinePath, baseline)) {
+            std::cerr << "ERROR::BENCH::BASELINE_MISSING: " << options.baselinePath
+                      << ", generate it with --update-baseline" << "\n";
+            baselineError = true;
+            passed = false;
+        }
+
+        for (TimingResult& timing : timings) {
+            auto entry = baseline.find(timing.name);
+            if (entry != baseline.end()) {
+                timing.baselineUs = entry->second;
+                timing.withinBaseline = timing.medianUs <= entry->second * (1.0 + options.baselineTolerance);
+                passed = passed && timing.withinBaseline;
+            }
+        }
+    }
+#endif
+
+    // Report
+    if (options.jsonPath.empty()) {
+        writeJson(std::cout, golden, checks, timings, options.rounds, passed);
+    } else {
+        std::ofstream file(options.jsonPath);
+        if (!file.is_open()) {
+            std::cerr << "ERROR::BENCH::JSON_NOT_WRITTEN: " << options.jsonPath << "\n";
+            return 2;
+        }
+        writeJson(file, golden, checks, timings, options.rounds, passed);
+    }
+
+    if (missingReferences > 0 || baselineError) {
+        return 2;
+    }
+    return passed ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    GLFWwindow* window = createHiddenContext();
+    if (!window) {
+        return 2;
+    }
+
+    int status;
+    try {
+        status = runBench(options);
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR::BENCH::" << e.what() << "\n";
+        status = 2;
+    }
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return status;
+}
@@ -0,0 +1,35 @@
+#include "attitude_source.h"
+
+#include <cmath>
+#include <random>
+
+SimulatedAttitudeSource::SimulatedAttitudeSource(unsigned int seed)
+    : m_start(std::chrono::steady_clock::now()), m_lastSample(-1) {
+    std::minstd_rand rng(seed + 1);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    // Telemetry rates between 5 and 30 Hz
+    m_samplePeriod = 1.0 / (5.0 + 25.0 * unit(rng));
+
+    m_pitchAmplitude = 5.0f + 30.0f * unit(rng);
+    m_pitchFrequency = 0.05f + 0.2f * unit(rng);
+    m_pitchPhase = 6.2831853f * unit(rng);
+
+    m_rollAmplitude = 10.0f + 70.0f * unit(rng);
+    m_rollFrequency = 0.05f + 0.3f * unit(rng);
+    m_rollPhase = 6.2831853f * unit(rng);
+}
+
+bool SimulatedAttitudeSource::poll(Attitude& attitude) {
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+    long long sample = (long long)(elapsed / m_samplePeriod);
+    if (sample == m_lastSample) {
+        return false;
+    }
+    m_lastSample = sample;
+
+    float t = (float)(sample * m_samplePeriod);
+    attitude.pitch = m_pitchAmplitude * std::sin(6.2831853f * m_pitchFrequency * t + m_pitchPhase);
+    attitude.roll = m_rollAmplitude * std::sin(6.2831853f * m_rollFrequency * t + m_rollPhase);
+    return true;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+
+struct Attitude {
+    float pitch = 0.0f; // In Degrees
+    float roll = 0.0f;  // In Degrees
+};
+
+// A stream of attitude samples for one aircraft
+class AttitudeSource {
+public:
+    virtual ~AttitudeSource() = default;
+
+    // Returns true and fills attitude when a new sample arrived since the last poll
+    virtual bool poll(Attitude& attitude) = 0;
+};
+
+// Synthetic aircraft: slow pitch/roll oscillations sampled at a fixed rate, so
+// most frames see no new data (like a real telemetry link). The seed fixes the
+// phases and rates, but samples follow the wall clock and differ between runs.
+class SimulatedAttitudeSource : public AttitudeSource {
+public:
+    SimulatedAttitudeSource(unsigned int seed);
+
+    bool poll(Attitude& attitude) override;
+
+private:
+    std::chrono::steady_clock::time_point m_start;
+    double m_samplePeriod; // Seconds between samples
+    long long m_lastSample;
+
+    // Oscillation parameters
+    float m_pitchAmplitude, m_pitchFrequency, m_pitchPhase;
+    float m_rollAmplitude, m_rollFrequency, m_rollPhase;
+};
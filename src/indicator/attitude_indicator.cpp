@@ -0,0 +1,58 @@
+#include "attitude_indicator.h"
+
+#include <glm/glm.hpp>
+
+AttitudeSprites initAttitudeSprites(SpriteRenderer& spriteRenderer, float availableWidth, float availableHeight, float pxSize) {
+    AttitudeSprites indicator;
+
+    // Calculate center position based on available space
+    glm::vec2 pxScale = glm::vec2(pxSize, pxSize);
+    glm::vec2 centerPos = glm::vec2(
+        availableWidth / 2.0f - pxScale.x / 2.0f,
+        availableHeight / 2.0f - pxScale.y / 2.0f
+    );
+
+    // Create textures
+    indicator.textures[ATTITUDE_LAYER_INNER].reset(new Texture(ASSET_DIR "inner.png"));
+    indicator.textures[ATTITUDE_LAYER_OUTER].reset(new Texture(ASSET_DIR "outer.png"));
+    indicator.textures[ATTITUDE_LAYER_CENTER].reset(new Texture(ASSET_DIR "center.png"));
+    indicator.textures[ATTITUDE_LAYER_TOP].reset(new Texture(ASSET_DIR "top.png"));
+
+    // Create and add sprites to renderer, back to front
+    for (int layer = 0; layer < ATTITUDE_LAYER_COUNT; ++layer) {
+        indicator.sprites[layer].reset(new Sprite(indicator.textures[layer].get(), Transform(centerPos, pxScale)));
+        spriteRenderer.addSprite(indicator.sprites[layer].get());
+    }
+
+    return indicator;
+}
+
+void updateAttitudeSprites(const AttitudeSprites& attitudeSprites, float pitch, float roll, bool showStationary) {
+    Sprite* innerSprite = attitudeSprites.sprites[ATTITUDE_LAYER_INNER].get();
+    Sprite* outerSprite = attitudeSprites.sprites[ATTITUDE_LAYER_OUTER].get();
+    Sprite* centerSprite = attitudeSprites.sprites[ATTITUDE_LAYER_CENTER].get();
+    Sprite* topSprite = attitudeSprites.sprites[ATTITUDE_LAYER_TOP].get();
+
+    // Set indicator properties
+    topSprite->renderSprite = showStationary;
+    centerSprite->renderSprite = showStationary;
+
+    // Compute rotation matrix for the current roll
+    float rollRadians = glm::radians(roll);
+    glm::mat2 parentRotationMatrix = glm::mat2(
+        glm::cos(rollRadians), glm::sin(rollRadians),
+        -glm::sin(rollRadians), glm::cos(rollRadians)
+    );
+
+    glm::vec2 localOffset = glm::vec2(0, pitch * outerSprite->transform.scale.y / INDICATOR_PX_SIZE);
+    glm::vec2 globalOffset = parentRotationMatrix * localOffset;
+    innerSprite->transform.position = outerSprite->transform.position + globalOffset;
+
+    innerSprite->transform.rotation = roll;
+    outerSprite->transform.rotation = roll;
+}
+
+void setAttitudeValid(const AttitudeSprites& attitudeSprites, bool valid) {
+    attitudeSprites.sprites[ATTITUDE_LAYER_INNER]->renderSprite = valid;
+    attitudeSprites.sprites[ATTITUDE_LAYER_OUTER]->renderSprite = valid;
+}
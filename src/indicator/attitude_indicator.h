@@ -0,0 +1,37 @@
+#pragma once
+
+#include "renderer/sprite_renderer.h"
+#include "renderer/sprite.h"
+#include "renderer/texture.h"
+
+#include <memory>
+
+/*
+* Indicator Properties
+*/
+#define INDICATOR_PX_SIZE 350
+
+// Layer order, back to front
+enum AttitudeLayer {
+    ATTITUDE_LAYER_INNER = 0,
+    ATTITUDE_LAYER_OUTER,
+    ATTITUDE_LAYER_CENTER,
+    ATTITUDE_LAYER_TOP,
+    ATTITUDE_LAYER_COUNT
+};
+
+// Owns the indicator textures and sprites, the SpriteRenderer only references them
+struct AttitudeSprites {
+    std::unique_ptr<Texture> textures[ATTITUDE_LAYER_COUNT];
+    std::unique_ptr<Sprite> sprites[ATTITUDE_LAYER_COUNT];
+};
+
+// Creates the indicator sprites centered in the available space and adds them to the renderer
+AttitudeSprites initAttitudeSprites(SpriteRenderer& spriteRenderer, float availableWidth, float availableHeight,
+                                    float pxSize = INDICATOR_PX_SIZE);
+
+// Poses the indicator sprites for the given attitude (degrees), pitch moves 1px per degree at INDICATOR_PX_SIZE
+void updateAttitudeSprites(const AttitudeSprites& attitudeSprites, float pitch, float roll, bool showStationary);
+
+// Hides the moving layers when there is no valid attitude, so the indicator never shows a stale or made-up pose
+void setAttitudeValid(const AttitudeSprites& attitudeSprites, bool valid);
@@ -3,7 +3,21 @@
 #include "renderer/sprite_renderer.h"
 #include "renderer/texture.h"
 #include "renderer/sprite.h"
-
+#include "renderer/framebuffer.h"
+#include "renderer/gpu_timer.h"
+#include "renderer/fleet_renderer.h"
+#include "renderer/residency_manager.h"
+#include "system/frame_governor.h"
+#include "system/flight_recorder.h"
+#include "system/frame_stats.h"
+#include "indicator/attitude_indicator.h"
+#include "data/attitude_source.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
 #include <string>
 #include <glm/glm.hpp>
 #include <windows.h>
@@ -15,10 +29,77 @@
 */
 #define SCREEN_WIDTH 800
 #define SCREEN_HEIGHT 400
-#define INDICATOR_PX_SIZE 350
+
+/*
+* Frame Budget
+*/
+#define FRAME_BUDGET_MS 14.0f
+
+/*
+* Fleet Mode
+*/
+#define FLEET_DEFAULT_AIRCRAFT 256
+
+/*
+* Kiosk Attitude
+*/
+#define ATTITUDE_STALE_MS 1000 // Without a sample for this long the kiosk shows NO DATA
+
+/*
+* Black Box
+*/
+#define RECORDER_DIR "recordings" // Next to the executable, the working directory may not be writable
+
+/*
+* GPU Memory
+*/
+#define GPU_MEMORY_BUDGET_MB 40
+
+// Directory holding the executable, with a trailing separator
+std::string executableDir() {
+    char path[MAX_PATH];
+    DWORD length = GetModuleFileNameA(NULL, path, MAX_PATH);
+    if (length == 0 || length == MAX_PATH) {
+        return "";
+    }
+
+    std::string dir(path, length);
+    size_t separator = dir.find_last_of("\\/");
+    return separator == std::string::npos ? "" : dir.substr(0, separator + 1);
+}
+
+#ifndef INDICATOR_KIOSK
+// GPU memory usage and budget, shared by both panels
+void showGpuMemorySection() {
+    if (!ImGui::CollapsingHeader("GPU Memory")) {
+        return;
+    }
+
+    ResidencyManager& residency = ResidencyManager::get();
+    const float mb = 1024.0f * 1024.0f;
+
+    int budgetMb = (int)(residency.getBudgetBytes() / (long long)mb);
+    if (ImGui::SliderInt("Budget##gpu", &budgetMb, 8, 256, "%d MB")) {
+        residency.setBudgetBytes((long long)budgetMb * 1024 * 1024);
+    }
+
+    ImGui::Text("Total: %.1f MB", residency.getTotalBytes() / mb);
+    ImGui::Text("Textures: %.1f MB", residency.getBytes(GPU_RESOURCE_TEXTURE) / mb);
+    ImGui::Text("Buffers: %.1f KB", residency.getBytes(GPU_RESOURCE_BUFFER) / 1024.0f);
+    ImGui::Text("Targets: %.1f MB", residency.getBytes(GPU_RESOURCE_FRAMEBUFFER) / mb);
+    ImGui::Text("Streaming: %d", residency.getStreamingCount());
+    ImGui::TextDisabled("Not counted: ImGui vertex buffers, timer queries");
+
+    static const char* residencyNames[] = { "Resident", "Downscaled", "Evicted", "Failed" };
+    for (const Texture* texture : residency.getTextures()) {
+        const std::string& path = texture->getPath();
+        ImGui::TextWrapped("%s %dpx %s", path.substr(path.find_last_of("/\\") + 1).c_str(),
+            texture->getWidth(), residencyNames[texture->getResidency()]);
+    }
+}
 
 // Function to setup the ImGUI right panel
-void setupRightPanel(float& pitch, float& roll, bool& showStationary) {
+void setupRightPanel(float& pitch, float& roll, bool& showStationary, FrameGovernor& governor, const FlightRecorder& recorder) {
     ImGui::SetNextWindowSize(ImVec2(SCREEN_WIDTH * 0.25f, SCREEN_HEIGHT));
     ImGui::SetNextWindowPos(ImVec2(SCREEN_WIDTH * 0.75f, 0));
 
@@ -45,6 +126,28 @@ void setupRightPanel(float& pitch, float& roll, bool& showStationary) {
         ImGui::Text("Stationary: %s", showStationary ? "Yes" : "No");
     }
 
+    // Performance Section
+    if (ImGui::CollapsingHeader("Performance", ImGuiTreeNodeFlags_DefaultOpen)) {
+        float budgetMs = governor.getBudgetMs();
+        if (ImGui::SliderFloat("Budget##frame", &budgetMs, 2.0f, 33.3f, "%.1f ms")) {
+            governor.setBudgetMs(budgetMs);
+        }
+
+        const QualityLevel& quality = governor.getQuality();
+        ImGui::Text("Frame: %.2f ms", governor.getAverageMs());
+        ImGui::Text("Scale: %.0f%% (level %d/%d)", quality.renderScale * 100.0f, governor.getLevel(), governor.getLevelCount() - 1);
+        ImGui::Text("LOD Bias: %.1f", quality.lodBias);
+        ImGui::Text("Trilinear: %s", quality.trilinear ? "Yes" : "No");
+    }
+
+    // Recorder Section
+    if (ImGui::CollapsingHeader("Recorder")) {
+        ImGui::Text("Written: %llu", (unsigned long long)recorder.getWrittenCount());
+        ImGui::Text("Dropped: %llu", (unsigned long long)recorder.getDroppedCount());
+    }
+
+    showGpuMemorySection();
+
     // Reset Button
     ImGui::Separator();
     if (ImGui::Button("Reset to Neutral Position", ImVec2(-1, 0))) {
@@ -56,36 +159,228 @@ void setupRightPanel(float& pitch, float& roll, bool& showStationary) {
     ImGui::End();
 }
 
-std::vector<Sprite*> initAttitudeSprites(SpriteRenderer& spriteRenderer, float availableWidth, float availableHeight) {
-    // Calculate center position based on available space
-    glm::vec2 pxScale = glm::vec2(INDICATOR_PX_SIZE, INDICATOR_PX_SIZE);
-    glm::vec2 centerPos = glm::vec2(
-        availableWidth / 2.0f - pxScale.x / 2.0f,
-        availableHeight / 2.0f - pxScale.y / 2.0f
-    );
+// Function to setup the ImGUI right panel in fleet mode
+void setupFleetPanel(FleetRenderer& fleet, bool& showStationary, float frameMs) {
+    ImGui::SetNextWindowSize(ImVec2(SCREEN_WIDTH * 0.25f, SCREEN_HEIGHT));
+    ImGui::SetNextWindowPos(ImVec2(SCREEN_WIDTH * 0.75f, 0));
+
+    ImGui::Begin("Fleet Controls", nullptr,
+        ImGuiWindowFlags_NoResize |
+        ImGuiWindowFlags_NoMove |
+        ImGuiWindowFlags_NoCollapse);
+
+    // Navigation Section
+    if (ImGui::CollapsingHeader("Navigation", ImGuiTreeNodeFlags_DefaultOpen)) {
+        int firstRow = fleet.getFirstRow();
+        if (ImGui::SliderInt("First Row", &firstRow, 0, fleet.getMaxFirstRow())) {
+            fleet.scrollRows(firstRow - fleet.getFirstRow());
+        }
+    }
+
+    // Visualization Section
+    if (ImGui::CollapsingHeader("Display Options", ImGuiTreeNodeFlags_DefaultOpen)) {
+        ImGui::Checkbox("Show Stationary Elements", &showStationary);
+    }
+
+    // Current State Section
+    if (ImGui::CollapsingHeader("Current State", ImGuiTreeNodeFlags_DefaultOpen)) {
+        ImGui::Text("Aircraft: %d", fleet.getCount());
+        ImGui::Text("On Screen: %d", fleet.getVisibleCount());
+        ImGui::Text("Redrawn: %d", fleet.getDrawnCount());
+        ImGui::Text("Draw Calls: %d", fleet.getDrawCalls());
+        ImGui::Text("Frame: %.2f ms", frameMs);
+    }
+
+    showGpuMemorySection();
+
+    ImGui::End();
+}
+
+// Returns the aircraft count passed with --fleet <count>, 0 for the single indicator
+int parseFleetCount(const char* cmdLine) {
+    const char* flag = cmdLine ? std::strstr(cmdLine, "--fleet") : nullptr;
+    if (!flag) {
+        return 0;
+    }
+
+    int count = std::atoi(flag + std::strlen("--fleet"));
+    return count > 0 ? count : FLEET_DEFAULT_AIRCRAFT;
+}
+
+// Fleet monitoring loop: a grid of indicators fed by one attitude stream each
+int runFleet(Window& window, int count) {
+    Shader fleetShader(ASSET_DIR "shaders/fleet.vs", ASSET_DIR "shaders/fleet.fs");
+    FleetRenderer fleet(fleetShader, count, (int)(SCREEN_WIDTH * 0.75f), SCREEN_HEIGHT);
+
+    std::vector<std::unique_ptr<AttitudeSource>> sources;
+    sources.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        sources.emplace_back(new SimulatedAttitudeSource(i));
+    }
+
+    // Panel variables
+    bool showStationary = true;
+    float frameMs = 0.0f;
+
+    // Soft charcoal background color
+    glClearColor(0.10f, 0.10f, 0.12f, 1.0f);
+
+    // Render loop
+    while (!window.shouldClose()) {
+        auto frameStart = std::chrono::steady_clock::now();
+
+        // Listen for the user to close the window (ESC key)
+        window.processInput();
+
+        // Upload streamed textures and enforce the memory budget
+        ResidencyManager::get().update();
+
+        window.beginImGuiFrame();
+
+        setupFleetPanel(fleet, showStationary, frameMs);
+
+        // Scroll the grid with the mouse wheel when the panel does not want it
+        ImGuiIO& io = ImGui::GetIO();
+        if (!io.WantCaptureMouse && io.MouseWheel != 0.0f) {
+            fleet.scrollRows(io.MouseWheel > 0.0f ? -1 : 1);
+        }
+
+        // Consume new samples, unchanged aircraft are not redrawn
+        Attitude attitude;
+        for (int i = 0; i < count; ++i) {
+            if (sources[i]->poll(attitude)) {
+                fleet.setAttitude(i, attitude.pitch, attitude.roll);
+            }
+        }
+        fleet.setShowStationary(showStationary);
+
+        // Render the grid and panel, the grid follows the window size
+        int framebufferWidth, framebufferHeight;
+        window.getFramebufferSize(framebufferWidth, framebufferHeight);
+
+        fleet.resize(std::max(1, (int)(framebufferWidth * 0.75f)), std::max(1, framebufferHeight));
+        fleet.render();
+        glViewport(0, 0, framebufferWidth, framebufferHeight);
+        glClear(GL_COLOR_BUFFER_BIT);
+        fleet.blitToScreen(0, 0, (int)(framebufferWidth * 0.75f), framebufferHeight);
+        window.renderImGui();
+
+        // Smoothed CPU frame time for the panel
+        float cpuMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+        frameMs = frameMs * 0.95f + cpuMs * 0.05f;
+
+        // Swap buffers and poll events
+        window.swapBuffersAndPollEvents();
+    }
+
+    return 0;
+}
+#endif
+
+#ifdef INDICATOR_KIOSK
+// Attitude source named by --source <name>. No hardware link source exists yet, so without
+// --source simulated there is no source and the kiosk stays in the NO DATA state.
+std::unique_ptr<AttitudeSource> parseAttitudeSource(const char* cmdLine) {
+    const char* flag = cmdLine ? std::strstr(cmdLine, "--source") : nullptr;
+    if (!flag) {
+        return nullptr;
+    }
+
+    const char* name = flag + std::strlen("--source");
+    while (*name == ' ' || *name == '=') {
+        ++name;
+    }
+
+    if (std::strncmp(name, "simulated", std::strlen("simulated")) == 0) {
+        return std::unique_ptr<AttitudeSource>(new SimulatedAttitudeSource(0));
+    }
 
-    // Create textures
-    Texture* outerTexture = new Texture(ASSET_DIR "outer.png");
-    Texture* innerTexture = new Texture(ASSET_DIR "inner.png");
-    Texture* centerTexture = new Texture(ASSET_DIR "center.png");
-    Texture* topTexture = new Texture(ASSET_DIR "top.png");
+    std::cerr << "ERROR::KIOSK::UNKNOWN_ATTITUDE_SOURCE: " << name << "\n";
+    return nullptr;
+}
 
-    // Create and add sprites to renderer
-    Sprite* innerSprite = new Sprite(innerTexture, Transform(centerPos, pxScale));
-    spriteRenderer.addSprite(innerSprite);
+// Production loop: no panel, the attitude comes only from the data source and the indicator fills the display
+int runKiosk(Window& window, std::unique_ptr<AttitudeSource> source) {
+    FrameStats stats("kiosk");
 
-    Sprite* outerSprite = new Sprite(outerTexture, Transform(centerPos, pxScale));
-    spriteRenderer.addSprite(outerSprite);
+    int width, height;
+    window.getFramebufferSize(width, height);
 
-    Sprite* centerSprite = new Sprite(centerTexture, Transform(centerPos, pxScale));
-    spriteRenderer.addSprite(centerSprite);
+    // Setup the renderer
+    Shader spriteShader(ASSET_DIR "shaders/sprite.vs", ASSET_DIR "shaders/sprite.fs");
+    SpriteRenderer spriteRenderer(spriteShader, width, height);
+    AttitudeSprites attitudeSprites = initAttitudeSprites(spriteRenderer, (float)width, (float)height, (float)std::min(width, height));
+
+    // Nothing is posed until the first sample arrives
+    const bool simulated = dynamic_cast<SimulatedAttitudeSource*>(source.get()) != nullptr;
+    Attitude attitude;
+    auto lastSample = std::chrono::steady_clock::time_point();
+    bool hasSample = false;
+    bool attitudeValid = true;
+
+    // Record what every frame displayed
+    FlightRecorder recorder(executableDir() + RECORDER_DIR);
+    recorder.start();
+    uint64_t frameIndex = 0;
+    bool startupLogged = false;
 
-    Sprite* topSprite = new Sprite(topTexture, Transform(centerPos, pxScale));
-    spriteRenderer.addSprite(topSprite);
+    // Render loop
+    while (!window.shouldClose()) {
+        auto frameStart = std::chrono::steady_clock::now();
+        stats.beginFrame();
 
-    // Return pointers to sprites
-    return {innerSprite, outerSprite, centerSprite, topSprite};
+        // Listen for the user to close the window (ESC key)
+        window.processInput();
+
+        // Upload streamed textures and enforce the memory budget
+        ResidencyManager::get().update();
+
+        // Pose the indicator when a new sample arrived
+        if (source && source->poll(attitude)) {
+            updateAttitudeSprites(attitudeSprites, attitude.pitch, attitude.roll, true);
+            lastSample = frameStart;
+            hasSample = true;
+        }
+
+        // Without a source, before the first sample or once the link goes quiet the moving layers
+        // are hidden and the background turns red, the indicator never holds a stale pose
+        bool valid = hasSample && frameStart - lastSample < std::chrono::milliseconds(ATTITUDE_STALE_MS);
+        if (valid != attitudeValid) {
+            attitudeValid = valid;
+            setAttitudeValid(attitudeSprites, valid);
+            if (!valid) {
+                glClearColor(0.45f, 0.05f, 0.05f, 1.0f); // NO DATA: dark red
+            } else if (simulated) {
+                glClearColor(0.30f, 0.22f, 0.02f, 1.0f); // Synthetic data: dark amber
+            } else {
+                glClearColor(0.10f, 0.10f, 0.12f, 1.0f); // Soft charcoal
+            }
+        }
+
+        FlightRecord record;
+        record.frameIndex = frameIndex++;
+        record.timestampNs = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(frameStart.time_since_epoch()).count();
+        record.pitch = valid ? attitude.pitch : 0.0f;
+        record.roll = valid ? attitude.roll : 0.0f;
+        record.flags = RECORD_FLAG_SHOW_STATIONARY | (valid ? 0u : RECORD_FLAG_NO_DATA) | (simulated ? RECORD_FLAG_SIMULATED : 0u);
+        record.qualityLevel = 0;
+        recorder.append(record);
+
+        spriteRenderer.render();
+        stats.endFrame();
+
+        // Swap buffers and poll events
+        window.swapBuffersAndPollEvents();
+
+        if (!startupLogged) {
+            stats.markStartupComplete();
+            startupLogged = true;
+        }
+    }
+
+    return 0;
 }
+#endif
 
 int APIENTRY WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow) {
 #ifdef SHOW_CONSOLE
@@ -98,6 +393,12 @@ int APIENTRY WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLi
 
     // Initialize window
     Window window("Attitude Indicator", SCREEN_WIDTH, SCREEN_HEIGHT);
+#ifdef INDICATOR_KIOSK
+    // The kiosk fills the primary monitor
+    if (!window.init(true)) {
+        return -1;
+    }
+#else
     if (!window.init()) {
         return -1;
     }
@@ -105,58 +406,116 @@ int APIENTRY WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLi
     if (!window.initImGui()) {
         return -1;
     }
+#endif
+
+    // Idle textures are reduced to keep inside the budget
+    ResidencyManager::get().setBudgetBytes((long long)GPU_MEMORY_BUDGET_MB * 1024 * 1024);
+
+#ifdef INDICATOR_KIOSK
+    return runKiosk(window, parseAttitudeSource(lpCmdLine));
+#else
+
+    // Fleet monitoring replaces the single indicator when requested
+    int fleetCount = parseFleetCount(lpCmdLine);
+    if (fleetCount > 0) {
+        return runFleet(window, fleetCount);
+    }
 
     // Setup the renderer
     Shader spriteShader(ASSET_DIR "shaders/sprite.vs", ASSET_DIR "shaders/sprite.fs");
     SpriteRenderer spriteRenderer(spriteShader, SCREEN_WIDTH, SCREEN_HEIGHT);
 
-    // Initialize sprites and get pointers to them
-    std::vector<Sprite*> attitudeSprites = initAttitudeSprites(spriteRenderer, SCREEN_WIDTH * 0.75f, SCREEN_HEIGHT);
-    Sprite* innerSprite = attitudeSprites[0];
-    Sprite* outerSprite = attitudeSprites[1];
-    Sprite* centerSprite = attitudeSprites[2];
-    Sprite* topSprite = attitudeSprites[3];
+    // Initialize sprites, the textures and sprites are owned by attitudeSprites
+    AttitudeSprites attitudeSprites = initAttitudeSprites(spriteRenderer, SCREEN_WIDTH * 0.75f, SCREEN_HEIGHT);
 
     // Panel variables
     float pitch = 0.0f, roll = 0.0f;
     bool showStationary = true;
 
+    // Below full scale the indicator renders offscreen at a resolution chosen by the governor
+    FrameGovernor governor(FRAME_BUDGET_MS);
+    Framebuffer sceneTarget(1, 1);
+    GpuTimer sceneTimer;
+
+    // Record what every frame displayed
+    FlightRecorder recorder(executableDir() + RECORDER_DIR);
+    recorder.start();
+    uint64_t frameIndex = 0;
+
+    // Startup and frame cost, compared against the kiosk build
+    FrameStats stats("developer");
+    bool startupLogged = false;
+
     // Soft charcoal background color
     glClearColor(0.10f, 0.10f, 0.12f, 1.0f);
 
     // Render loop
     while (!window.shouldClose()) {
+        auto frameStart = std::chrono::steady_clock::now();
+        stats.beginFrame();
+
         // Listen for the user to close the window (ESC key)
         window.processInput();
-        window.beginImGuiFrame();
 
-        setupRightPanel(pitch, roll, showStationary);
+        // Upload streamed textures and enforce the memory budget
+        ResidencyManager::get().update();
 
-        // Set indicator properties
-        topSprite->renderSprite = showStationary;
-        centerSprite->renderSprite = showStationary;
-
-        // Compute rotation matrix for the current roll
-        float rollRadians = glm::radians(roll);
-        glm::mat2 parentRotationMatrix = glm::mat2(
-            glm::cos(rollRadians), glm::sin(rollRadians),
-            -glm::sin(rollRadians), glm::cos(rollRadians)
-        );
-
-        glm::vec2 localOffset = glm::vec2(0, pitch);
-        glm::vec2 globalOffset = parentRotationMatrix * localOffset;
-        innerSprite->transform.position = outerSprite->transform.position + globalOffset;
-
-        innerSprite->transform.rotation = roll;
-        outerSprite->transform.rotation = roll;
+        window.beginImGuiFrame();
 
-        // Render the sprites and panel
-        spriteRenderer.render();
+        setupRightPanel(pitch, roll, showStationary, governor, recorder);
+
+        // Pose the indicator for the current attitude
+        updateAttitudeSprites(attitudeSprites, pitch, roll, showStationary);
+
+        FlightRecord record;
+        record.frameIndex = frameIndex++;
+        record.timestampNs = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(frameStart.time_since_epoch()).count();
+        record.pitch = pitch;
+        record.roll = roll;
+        record.flags = showStationary ? RECORD_FLAG_SHOW_STATIONARY : 0u;
+        record.qualityLevel = (uint32_t)governor.getLevel();
+        recorder.append(record);
+
+        // Render the sprites at the governed scale, upscaling to the window only when reduced
+        int framebufferWidth, framebufferHeight;
+        window.getFramebufferSize(framebufferWidth, framebufferHeight);
+
+        const QualityLevel& quality = governor.getQuality();
+        sceneTimer.begin();
+        if (quality.renderScale < 1.0f) {
+            sceneTarget.resize(std::max(1, (int)(framebufferWidth * quality.renderScale)),
+                               std::max(1, (int)(framebufferHeight * quality.renderScale)));
+            sceneTarget.bind();
+            spriteRenderer.render();
+            sceneTarget.blitToScreen(framebufferWidth, framebufferHeight);
+        } else {
+            // Full scale draws straight to the window, the offscreen target is released
+            sceneTarget.resize(1, 1);
+            glViewport(0, 0, framebufferWidth, framebufferHeight);
+            spriteRenderer.render();
+        }
+        sceneTimer.end();
+
+        // Render the panel at full resolution
         window.renderImGui();
 
+        // Govern on the slower of the CPU frame work and the GPU scene time
+        float cpuMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+        if (governor.recordFrame(std::max(cpuMs, sceneTimer.getLastMs()))) {
+            const QualityLevel& newQuality = governor.getQuality();
+            spriteRenderer.setTextureQuality(newQuality.lodBias, newQuality.trilinear);
+        }
+        stats.endFrame();
+
         // Swap buffers and poll events
         window.swapBuffersAndPollEvents();
+
+        if (!startupLogged) {
+            stats.markStartupComplete();
+            startupLogged = true;
+        }
     }
 
     return 0;
+#endif
 }
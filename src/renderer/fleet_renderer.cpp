@@ -0,0 +1,281 @@
+#include "fleet_renderer.h"
+#include "residency_manager.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+/*
+* Fleet Layout
+*/
+#define FLEET_MIN_CELL_PX 48.0f
+#define FLEET_CELL_GAP 0.08f // Fraction of the cell pitch left between cells
+#define FLEET_CELL_ALIGN_PX 4.0f // Software rasterizers shade 4x4 pixel blocks, cells start and end on them
+
+// Layers are baked at the cell size, so nearest sampling is off by half a texel at most
+// and keeps a software rasterizer inside the frame budget, where filtering dominates the cost
+#define FLEET_LAYER_FILTER GL_NEAREST
+#define FLEET_LAYER_MARGIN 1 // Transparent texels around each baked layer
+
+// Matches the clear color of the single indicator view
+static const glm::vec3 FLEET_BACKGROUND = glm::vec3(0.10f, 0.10f, 0.12f);
+static const glm::vec3 FLEET_CELL_BACKGROUND = glm::vec3(0.14f, 0.14f, 0.17f);
+
+FleetRenderer::FleetRenderer(Shader& shader, int count, int width, int height)
+    : m_shader(shader), m_cache(width, height),
+      m_bakeShader(ASSET_DIR "shaders/sprite.vs", ASSET_DIR "shaders/sprite.fs"), m_bakeRenderer(m_bakeShader, 1, 1), m_layerSize(0), m_layersDirty(true),
+      m_instances(count), m_dirty(count, 1), m_showStationary(true), m_layoutDirty(true),
+      m_width(width), m_height(height), m_firstRow(0), m_drawnCount(0), m_drawCalls(0) {
+    // Textures are shared by every indicator in the grid
+    m_layerTextures[ATTITUDE_LAYER_INNER].reset(new Texture(ASSET_DIR "inner.png"));
+    m_layerTextures[ATTITUDE_LAYER_OUTER].reset(new Texture(ASSET_DIR "outer.png"));
+    m_layerTextures[ATTITUDE_LAYER_CENTER].reset(new Texture(ASSET_DIR "center.png"));
+    m_layerTextures[ATTITUDE_LAYER_TOP].reset(new Texture(ASSET_DIR "top.png"));
+
+    // Each layer fills the unit viewport of the bake renderer
+    for (int layer = 0; layer < ATTITUDE_LAYER_COUNT; ++layer) {
+        m_bakeSprites[layer].reset(new Sprite(m_layerTextures[layer].get()));
+        m_bakeRenderer.addSprite(m_bakeSprites[layer].get());
+    }
+    // Baked with a transparent margin and clamped to it, so rolled and offset layers need no clipping.
+    // Border clamping would do the same but costs a software rasterizer a quarter of the frame
+    for (auto& image : m_layerImages) {
+        image.reset(new Framebuffer(1, 1));
+        image->setSampling(FLEET_LAYER_FILTER, GL_CLAMP_TO_EDGE);
+    }
+
+    m_upload.reserve(count);
+    layoutGrid();
+    initRenderer();
+}
+
+FleetRenderer::~FleetRenderer() {
+    glDeleteVertexArrays(1, &m_VAO);
+    glDeleteBuffers(1, &m_quadVBO);
+    glDeleteBuffers(1, &m_instanceVBO);
+    ResidencyManager::get().addBytes(GPU_RESOURCE_BUFFER, -(long long)(sizeof(SPRITE_QUAD_VERTICES) + m_instances.size() * sizeof(FleetInstance)));
+}
+
+void FleetRenderer::setAttitude(int index, float pitch, float roll) {
+    FleetInstance& instance = m_instances[index];
+    if (instance.attitude.x != pitch || instance.attitude.y != roll) {
+        instance.attitude = glm::vec2(pitch, roll);
+        m_dirty[index] = 1;
+    }
+}
+
+void FleetRenderer::setShowStationary(bool showStationary) {
+    if (showStationary != m_showStationary) {
+        m_showStationary = showStationary;
+        m_layersDirty = true;
+        m_layoutDirty = true;
+    }
+}
+
+void FleetRenderer::scrollRows(int delta) {
+    int firstRow = std::max(0, std::min(m_firstRow + delta, getMaxFirstRow()));
+    if (firstRow != m_firstRow) {
+        m_firstRow = firstRow;
+        m_layoutDirty = true;
+    }
+}
+
+void FleetRenderer::resize(int width, int height) {
+    if (width == m_width && height == m_height) {
+        return;
+    }
+
+    m_width = width;
+    m_height = height;
+    m_cache.resize(width, height);
+    m_projection = glm::ortho(0.0f, (float)m_width, (float)m_height, 0.0f, -1.0f, 1.0f);
+
+    layoutGrid();
+    m_firstRow = std::min(m_firstRow, getMaxFirstRow());
+    m_layoutDirty = true;
+}
+
+int FleetRenderer::getVisibleCount() const {
+    int first = m_firstRow * m_columns;
+    int last = std::min((m_firstRow + m_visibleRows) * m_columns, getCount());
+    return std::max(0, last - first);
+}
+
+int FleetRenderer::getMaxFirstRow() const {
+    return std::max(0, m_rows - (int)(m_height / m_cellPitch));
+}
+
+void FleetRenderer::render() {
+    m_drawnCount = 0;
+    m_drawCalls = 0;
+
+    // Layer images follow the cell size so they are sampled close to 1:1
+    int layerSize = std::max(1, (int)std::ceil(cellFor(0).z));
+    if (layerSize != m_layerSize || m_layersDirty) {
+        bakeLayers(layerSize);
+    }
+
+    // Only cells intersecting the viewport are considered
+    int first = m_firstRow * m_columns;
+    int last = std::min((m_firstRow + m_visibleRows) * m_columns, getCount());
+
+    m_upload.clear();
+    for (int i = first; i < last; ++i) {
+        if (m_dirty[i] || m_layoutDirty) {
+            FleetInstance instance = m_instances[i];
+            instance.cell = cellFor(i);
+            m_upload.push_back(instance);
+            m_dirty[i] = 0;
+        }
+    }
+
+    m_cache.bind();
+    if (m_layoutDirty) {
+        glClearColor(FLEET_BACKGROUND.r, FLEET_BACKGROUND.g, FLEET_BACKGROUND.b, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        m_layoutDirty = false;
+    }
+
+    if (!m_upload.empty()) {
+        // Orphan the buffer so the upload never waits on the previous frame
+        glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, m_instances.size() * sizeof(FleetInstance), nullptr, GL_DYNAMIC_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, m_upload.size() * sizeof(FleetInstance), m_upload.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        m_shader.use();
+        m_shader.setMat4("projection", m_projection);
+        m_shader.setFloat("indicatorSize", (float)INDICATOR_PX_SIZE);
+        m_shader.setFloat("layerMargin", (float)FLEET_LAYER_MARGIN / (m_layerSize + 2 * FLEET_LAYER_MARGIN));
+        m_shader.setVec3("backgroundColor", FLEET_CELL_BACKGROUND);
+        m_shader.setInt("innerImage", FLEET_LAYER_INNER);
+        m_shader.setInt("outerImage", FLEET_LAYER_OUTER);
+        m_shader.setInt("overlayImage", FLEET_LAYER_OVERLAY);
+        for (int layer = 0; layer < FLEET_LAYER_COUNT; ++layer) {
+            m_layerImages[layer]->bindColorTexture(layer);
+        }
+
+        // The shader composites every layer over an opaque background, blending would only add cost
+        glDisable(GL_BLEND);
+        glBindVertexArray(m_VAO);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 6, (GLsizei)m_upload.size());
+        glBindVertexArray(0);
+        glEnable(GL_BLEND);
+        glActiveTexture(GL_TEXTURE0);
+
+        m_drawCalls = 1;
+        m_drawnCount = (int)m_upload.size();
+    }
+
+    m_cache.unbind();
+}
+
+void FleetRenderer::blitToScreen(int x, int y, int width, int height) const {
+    m_cache.blitToRegion(x, y, width, height);
+}
+
+/*
+* Grid layout
+*/
+void FleetRenderer::layoutGrid() {
+    int count = std::max(1, getCount());
+
+    // Fit every indicator on screen when they stay readable, otherwise scroll
+    m_columns = std::max(1, (int)std::ceil(std::sqrt(count * (float)m_width / m_height)));
+    m_cellPitch = std::min((float)m_width / m_columns, (float)m_height / ((count + m_columns - 1) / m_columns));
+    if (m_cellPitch < FLEET_MIN_CELL_PX) {
+        m_cellPitch = FLEET_MIN_CELL_PX;
+        m_columns = std::max(1, (int)(m_width / m_cellPitch));
+    }
+    m_cellPitch = std::floor(m_cellPitch / FLEET_CELL_ALIGN_PX) * FLEET_CELL_ALIGN_PX;
+
+    m_rows = (count + m_columns - 1) / m_columns;
+    m_visibleRows = (int)std::ceil(m_height / m_cellPitch);
+}
+
+glm::vec3 FleetRenderer::cellFor(int index) const {
+    int column = index % m_columns;
+    int row = index / m_columns - m_firstRow;
+
+    // The gap is rounded to whole blocks and split around the cell in whole blocks too,
+    // so no block is shaded for two cells or only partly covered
+    float gap = std::max(FLEET_CELL_ALIGN_PX, std::round(m_cellPitch * FLEET_CELL_GAP / FLEET_CELL_ALIGN_PX) * FLEET_CELL_ALIGN_PX);
+    float inset = std::floor(gap * 0.5f / FLEET_CELL_ALIGN_PX) * FLEET_CELL_ALIGN_PX;
+    return glm::vec3(column * m_cellPitch + inset, row * m_cellPitch + inset, m_cellPitch - gap);
+}
+
+/*
+* Layer baking
+*/
+void FleetRenderer::bakeLayers(int size) {
+    GLfloat clearColor[4];
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+
+    // Premultiplied alpha so layers composite correctly onto a transparent image
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    for (int image = 0; image < FLEET_LAYER_COUNT; ++image) {
+        for (int layer = 0; layer < ATTITUDE_LAYER_COUNT; ++layer) {
+            bool stationary = layer == ATTITUDE_LAYER_CENTER || layer == ATTITUDE_LAYER_TOP;
+            m_bakeSprites[layer]->renderSprite = (image == FLEET_LAYER_OVERLAY) ? stationary && m_showStationary
+                : (image == FLEET_LAYER_INNER) ? layer == ATTITUDE_LAYER_INNER
+                : layer == ATTITUDE_LAYER_OUTER;
+        }
+
+        // The clear covers the margin, the layers only the inside
+        int imageSize = size + 2 * FLEET_LAYER_MARGIN;
+        m_layerImages[image]->resize(imageSize, imageSize);
+        m_layerImages[image]->bind();
+        glViewport(FLEET_LAYER_MARGIN, FLEET_LAYER_MARGIN, size, size);
+        m_bakeRenderer.render();
+    }
+
+    m_layerImages[0]->unbind();
+
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+    m_layerSize = size;
+    m_layersDirty = false;
+}
+
+void FleetRenderer::initRenderer() {
+    // Enable transparency
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDisable(GL_DEPTH_TEST);
+
+    m_projection = glm::ortho(0.0f, (float)m_width, (float)m_height, 0.0f, -1.0f, 1.0f);
+
+    // Create mesh buffers
+    glGenVertexArrays(1, &m_VAO);
+    glGenBuffers(1, &m_quadVBO);
+    glGenBuffers(1, &m_instanceVBO);
+
+    glBindVertexArray(m_VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(SPRITE_QUAD_VERTICES), SPRITE_QUAD_VERTICES, GL_STATIC_DRAW);
+    ResidencyManager::get().addBytes(GPU_RESOURCE_BUFFER, sizeof(SPRITE_QUAD_VERTICES));
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+
+    // One GPU buffer holds the per aircraft state
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, m_instances.size() * sizeof(FleetInstance), nullptr, GL_DYNAMIC_DRAW);
+    ResidencyManager::get().addBytes(GPU_RESOURCE_BUFFER, m_instances.size() * sizeof(FleetInstance));
+
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(FleetInstance), (void*)offsetof(FleetInstance, cell));
+    glVertexAttribDivisor(2, 1);
+
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(FleetInstance), (void*)offsetof(FleetInstance, attitude));
+    glVertexAttribDivisor(3, 1);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
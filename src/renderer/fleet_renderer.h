@@ -0,0 +1,93 @@
+#pragma once
+
+#include "shader.h"
+#include "texture.h"
+#include "framebuffer.h"
+#include "indicator/attitude_indicator.h"
+
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Images sampled by the fleet shader, baked from the attitude layers
+enum FleetLayer {
+    FLEET_LAYER_INNER = 0,
+    FLEET_LAYER_OUTER,
+    FLEET_LAYER_OVERLAY,  // Center and top composited, they never move
+    FLEET_LAYER_COUNT
+};
+
+// Per aircraft state as laid out in the instance buffer
+struct FleetInstance {
+    glm::vec3 cell;     // origin.xy, size
+    glm::vec2 attitude; // pitch, roll (degrees)
+};
+
+// Draws a grid of attitude indicators with one instanced draw. The layers are
+// baked into cell sized images whenever the cell size changes, so each cell
+// pixel takes one texel per layer in a single pass. Indicators are cached in
+// an offscreen target and only redrawn when their attitude changed and their
+// cell is on screen.
+class FleetRenderer {
+public:
+    FleetRenderer(Shader& shader, int count, int width, int height);
+    ~FleetRenderer();
+
+    void setAttitude(int index, float pitch, float roll);
+    void setShowStationary(bool showStationary);
+    void scrollRows(int delta);
+
+    // Resizes the cached canvas and lays the grid out again
+    void resize(int width, int height);
+
+    // Redraws changed on-screen indicators into the cache
+    void render();
+    void blitToScreen(int x, int y, int width, int height) const;
+
+    /*
+    * Statistics
+    */
+    int getCount() const { return (int)m_instances.size(); }
+    int getVisibleCount() const;
+    int getDrawnCount() const { return m_drawnCount; }
+    int getDrawCalls() const { return m_drawCalls; }
+    int getFirstRow() const { return m_firstRow; }
+    int getMaxFirstRow() const;
+
+private:
+    // Rendering
+    Shader& m_shader;
+    unsigned int m_VAO, m_quadVBO, m_instanceVBO;
+    Framebuffer m_cache;
+    glm::mat4 m_projection;
+    void initRenderer();
+
+    // Layer baking, redone when the cell size or the stationary layers change
+    std::unique_ptr<Texture> m_layerTextures[ATTITUDE_LAYER_COUNT];
+    Shader m_bakeShader;
+    SpriteRenderer m_bakeRenderer;
+    std::unique_ptr<Sprite> m_bakeSprites[ATTITUDE_LAYER_COUNT];
+    std::unique_ptr<Framebuffer> m_layerImages[FLEET_LAYER_COUNT];
+    int m_layerSize;
+    bool m_layersDirty;
+    void bakeLayers(int size);
+
+    // Aircraft state
+    std::vector<FleetInstance> m_instances;
+    std::vector<unsigned char> m_dirty;
+    std::vector<FleetInstance> m_upload;
+    bool m_showStationary;
+    bool m_layoutDirty;
+
+    // Grid layout
+    int m_width, m_height;
+    int m_columns, m_rows, m_visibleRows;
+    float m_cellPitch;
+    int m_firstRow;
+    void layoutGrid();
+    glm::vec3 cellFor(int index) const;
+
+    // Last frame
+    int m_drawnCount;
+    int m_drawCalls;
+};
@@ -0,0 +1,97 @@
+#include "framebuffer.h"
+#include "residency_manager.h"
+#include <algorithm>
+#include <iostream>
+
+Framebuffer::Framebuffer(int width, int height) : m_Width(width), m_Height(height) {
+    glGenFramebuffers(1, &m_FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+
+    // Color attachment
+    glGenTextures(1, &m_ColorTexture);
+    glBindTexture(GL_TEXTURE_2D, m_ColorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_ColorTexture, 0);
+    ResidencyManager::get().addBytes(GPU_RESOURCE_FRAMEBUFFER, (long long)m_Width * m_Height * 4);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "ERROR::FRAMEBUFFER::INCOMPLETE\n";
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+Framebuffer::~Framebuffer() {
+    ResidencyManager::get().addBytes(GPU_RESOURCE_FRAMEBUFFER, -(long long)m_Width * m_Height * 4);
+    glDeleteFramebuffers(1, &m_FBO);
+    glDeleteTextures(1, &m_ColorTexture);
+}
+
+void Framebuffer::bind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+    glViewport(0, 0, m_Width, m_Height);
+}
+
+void Framebuffer::unbind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void Framebuffer::resize(int width, int height) {
+    if (width == m_Width && height == m_Height) {
+        return;
+    }
+
+    ResidencyManager::get().addBytes(GPU_RESOURCE_FRAMEBUFFER, ((long long)width * height - (long long)m_Width * m_Height) * 4);
+    m_Width = width;
+    m_Height = height;
+    glBindTexture(GL_TEXTURE_2D, m_ColorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void Framebuffer::blitToScreen(int screenWidth, int screenHeight) const {
+    blitToRegion(0, 0, screenWidth, screenHeight);
+    glViewport(0, 0, screenWidth, screenHeight);
+}
+
+void Framebuffer::blitToRegion(int x, int y, int width, int height) const {
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_FBO);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, m_Width, m_Height, x, y, x + width, y + height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void Framebuffer::bindColorTexture(unsigned int unit) const {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, m_ColorTexture);
+}
+
+void Framebuffer::setSampling(GLint filter, GLint wrap) {
+    glBindTexture(GL_TEXTURE_2D, m_ColorTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void Framebuffer::readPixels(std::vector<unsigned char>& pixels) const {
+    const size_t rowSize = (size_t)m_Width * 3;
+    std::vector<unsigned char> flipped(rowSize * m_Height);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_FBO);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, m_Width, m_Height, GL_RGB, GL_UNSIGNED_BYTE, flipped.data());
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    // OpenGL returns the bottom row first
+    pixels.resize(flipped.size());
+    for (int y = 0; y < m_Height; ++y) {
+        std::copy(flipped.begin() + (m_Height - 1 - y) * rowSize,
+                  flipped.begin() + (m_Height - y) * rowSize,
+                  pixels.begin() + y * rowSize);
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <vector>
+
+// Offscreen RGBA8 color target
+class Framebuffer {
+public:
+    Framebuffer(int width, int height);
+    ~Framebuffer();
+
+    // Binds the framebuffer and sets the viewport to cover it
+    void bind() const;
+    void unbind() const;
+
+    // Reallocates the color attachment, contents are undefined afterwards
+    void resize(int width, int height);
+
+    // Stretches the color attachment over the default framebuffer
+    void blitToScreen(int screenWidth, int screenHeight) const;
+
+    // Stretches the color attachment over a region of the default framebuffer (origin bottom left)
+    void blitToRegion(int x, int y, int width, int height) const;
+
+    // Binds the color attachment for sampling
+    void bindColorTexture(unsigned int unit = 0) const;
+    void setSampling(GLint filter, GLint wrap);
+
+    // Reads back the color attachment as tightly packed RGB rows, top row first
+    void readPixels(std::vector<unsigned char>& pixels) const;
+
+    int getWidth() const { return m_Width; }
+    int getHeight() const { return m_Height; }
+
+private:
+    unsigned int m_FBO, m_ColorTexture;
+    int m_Width, m_Height;
+};
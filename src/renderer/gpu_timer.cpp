@@ -0,0 +1,45 @@
+#include "gpu_timer.h"
+
+GpuTimer::GpuTimer() : m_current(0), m_active(false), m_lastMs(0.0f) {
+    glGenQueries(QUERY_COUNT, m_queries);
+    for (int i = 0; i < QUERY_COUNT; ++i) {
+        m_pending[i] = false;
+    }
+}
+
+GpuTimer::~GpuTimer() {
+    glDeleteQueries(QUERY_COUNT, m_queries);
+}
+
+void GpuTimer::begin() {
+    unsigned int query = m_queries[m_current];
+
+    // Collect the result this query held from an earlier frame
+    if (m_pending[m_current]) {
+        GLint available = 0;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            m_active = false; // Skip this frame rather than stall
+            return;
+        }
+
+        GLuint64 elapsedNs = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsedNs);
+        m_lastMs = (float)(elapsedNs / 1.0e6);
+        m_pending[m_current] = false;
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, query);
+    m_active = true;
+}
+
+void GpuTimer::end() {
+    if (!m_active) {
+        return;
+    }
+
+    glEndQuery(GL_TIME_ELAPSED);
+    m_pending[m_current] = true;
+    m_current = (m_current + 1) % QUERY_COUNT;
+    m_active = false;
+}
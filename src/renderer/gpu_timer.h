@@ -0,0 +1,25 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// GPU time of a span of commands via GL_TIME_ELAPSED queries.
+// Results are read a few frames late so the CPU never waits on the GPU.
+class GpuTimer {
+public:
+    GpuTimer();
+    ~GpuTimer();
+
+    void begin();
+    void end();
+
+    // Latest completed measurement in milliseconds, 0 until one is available
+    float getLastMs() const { return m_lastMs; }
+
+private:
+    static const int QUERY_COUNT = 3;
+    unsigned int m_queries[QUERY_COUNT];
+    bool m_pending[QUERY_COUNT];
+    int m_current;
+    bool m_active;
+    float m_lastMs;
+};
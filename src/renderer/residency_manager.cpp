@@ -0,0 +1,255 @@
+#include "residency_manager.h"
+#include "texture.h"
+
+#include <stb/stb_image.h>
+
+#include <algorithm>
+#include <iostream>
+
+/*
+* Residency Properties
+*/
+#define RESIDENCY_IDLE_FRAMES 120 // Frames without a bind before a texture may be reduced
+#define RESIDENCY_UPLOAD_ROWS 256 // Rows streamed per frame, 1.25 MB of a 1280 px RGBA image
+
+ResidencyManager& ResidencyManager::get() {
+    static ResidencyManager manager;
+    return manager;
+}
+
+ResidencyManager::ResidencyManager() : m_budgetBytes(0), m_nextId(0), m_frame(0), m_nextWarningFrame(0), m_stopping(false) {
+    for (int i = 0; i < GPU_RESOURCE_KIND_COUNT; ++i) {
+        m_bytes[i] = 0;
+    }
+}
+
+ResidencyManager::~ResidencyManager() {
+    if (m_worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_streamMutex);
+            m_stopping = true;
+        }
+        m_streamWake.notify_one();
+        m_worker.join();
+    }
+
+    for (StreamResult& result : m_results) {
+        stbi_image_free(result.data);
+    }
+    for (StreamResult& upload : m_uploads) {
+        stbi_image_free(upload.data);
+    }
+}
+
+/*
+* Accounting
+*/
+void ResidencyManager::addBytes(GpuResourceKind kind, long long bytes) {
+    m_bytes[kind] += bytes;
+}
+
+long long ResidencyManager::getTotalBytes() const {
+    long long total = 0;
+    for (int i = 0; i < GPU_RESOURCE_KIND_COUNT; ++i) {
+        total += m_bytes[i];
+    }
+    return total;
+}
+
+/*
+* Texture residency
+*/
+void ResidencyManager::registerTexture(Texture* texture) {
+    m_textures.push_back(texture);
+    m_entries[texture] = { m_nextId++, m_frame, false };
+}
+
+void ResidencyManager::unregisterTexture(Texture* texture) {
+    m_textures.erase(std::remove(m_textures.begin(), m_textures.end(), texture), m_textures.end());
+    m_entries.erase(texture);
+}
+
+void ResidencyManager::markUsed(const Texture* texture) {
+    auto entry = m_entries.find(texture);
+    if (entry == m_entries.end()) {
+        return;
+    }
+
+    // Failed loads are reported once instead of retried on every bind
+    entry->second.lastUsedFrame = m_frame;
+    TextureResidency residency = texture->getResidency();
+    if (residency == TEXTURE_RESIDENT || residency == TEXTURE_FAILED || entry->second.streaming) {
+        return;
+    }
+
+    // Stream the full resolution image back in the background
+    entry->second.streaming = true;
+    {
+        std::lock_guard<std::mutex> lock(m_streamMutex);
+        m_requests.push_back({ entry->second.id, texture->getPath() });
+    }
+
+    if (!m_worker.joinable()) {
+        m_worker = std::thread(&ResidencyManager::workerLoop, this);
+    }
+    m_streamWake.notify_one();
+}
+
+int ResidencyManager::getStreamingCount() const {
+    int streaming = 0;
+    for (const auto& entry : m_entries) {
+        if (entry.second.streaming) {
+            streaming++;
+        }
+    }
+    return streaming;
+}
+
+void ResidencyManager::update() {
+    m_frame++;
+
+    {
+        std::lock_guard<std::mutex> lock(m_streamMutex);
+        m_uploads.insert(m_uploads.end(), m_results.begin(), m_results.end());
+        m_results.clear();
+    }
+
+    uploadStreamBand();
+    enforceBudget();
+}
+
+Texture* ResidencyManager::findTexture(unsigned long long id) {
+    for (Texture* texture : m_textures) {
+        if (m_entries[texture].id == id) {
+            return texture;
+        }
+    }
+    return nullptr;
+}
+
+void ResidencyManager::uploadStreamBand() {
+    // Skip loads that failed or whose texture was destroyed in the meantime
+    while (!m_uploads.empty()) {
+        StreamResult& upload = m_uploads.front();
+        Texture* texture = findTexture(upload.id);
+        if (texture && upload.data) {
+            break;
+        }
+
+        if (texture) {
+            m_entries[texture].streaming = false;
+            if (!upload.data) {
+                texture->markFailed();
+            }
+        }
+        stbi_image_free(upload.data);
+        m_uploads.pop_front();
+    }
+
+    if (m_uploads.empty()) {
+        return;
+    }
+
+    // Bound the upload per frame instead of sending the whole image at once
+    StreamResult& upload = m_uploads.front();
+    Texture* texture = findTexture(upload.id);
+    if (upload.uploadedRows == 0) {
+        texture->beginStream(upload.width, upload.height, upload.channels);
+    }
+
+    int rows = std::min(RESIDENCY_UPLOAD_ROWS, upload.height - upload.uploadedRows);
+    texture->streamRows(upload.data, upload.uploadedRows, rows);
+    upload.uploadedRows += rows;
+    if (upload.uploadedRows < upload.height) {
+        return;
+    }
+
+    texture->finishStream();
+    m_entries[texture].streaming = false;
+    std::cout << "[Residency] Streamed in " << texture->getPath() << "\n";
+    stbi_image_free(upload.data);
+    m_uploads.pop_front();
+}
+
+void ResidencyManager::enforceBudget() {
+    if (m_budgetBytes <= 0 || getTotalBytes() <= m_budgetBytes) {
+        return;
+    }
+
+    // Least recently used idle textures first
+    std::vector<Texture*> candidates;
+    for (Texture* texture : m_textures) {
+        const TextureEntry& entry = m_entries[texture];
+        // Failed textures could never be streamed back
+        TextureResidency residency = texture->getResidency();
+        if (residency != TEXTURE_EVICTED && residency != TEXTURE_FAILED && !entry.streaming &&
+            m_frame - entry.lastUsedFrame > RESIDENCY_IDLE_FRAMES) {
+            candidates.push_back(texture);
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [this](Texture* a, Texture* b) {
+        return m_entries[a].lastUsedFrame < m_entries[b].lastUsedFrame;
+    });
+
+    // Halve each candidate in turn, evicting those already at the minimum size
+    bool reduced = true;
+    while (getTotalBytes() > m_budgetBytes && reduced) {
+        reduced = false;
+        for (Texture* texture : candidates) {
+            if (getTotalBytes() <= m_budgetBytes) {
+                break;
+            }
+
+            if (texture->getResidency() == TEXTURE_EVICTED) {
+                continue;
+            }
+
+            if (texture->downscale()) {
+                std::cout << "[Residency] Downscaled " << texture->getPath()
+                          << " to " << texture->getWidth() << "x" << texture->getHeight() << "\n";
+            } else {
+                texture->evict();
+                std::cout << "[Residency] Evicted " << texture->getPath() << "\n";
+            }
+            reduced = true;
+        }
+    }
+
+    if (getTotalBytes() > m_budgetBytes) {
+        // Resources in use are never reduced, warn now and then
+        if (m_frame >= m_nextWarningFrame) {
+            std::cerr << "[Residency] Resources in use exceed the budget: "
+                      << getTotalBytes() << " of " << m_budgetBytes << " bytes\n";
+            m_nextWarningFrame = m_frame + RESIDENCY_IDLE_FRAMES;
+        }
+    }
+}
+
+/*
+* Streaming worker
+*/
+void ResidencyManager::workerLoop() {
+    while (true) {
+        StreamRequest request;
+        {
+            std::unique_lock<std::mutex> lock(m_streamMutex);
+            m_streamWake.wait(lock, [this] { return m_stopping || !m_requests.empty(); });
+            if (m_stopping) {
+                return;
+            }
+            request = m_requests.front();
+            m_requests.pop_front();
+        }
+
+        // Decode outside the lock, the GL upload happens in update()
+        StreamResult result = { request.id, nullptr, 0, 0, 0, 0 };
+        result.data = stbi_load(request.path.c_str(), &result.width, &result.height, &result.channels, 0);
+        if (!result.data) {
+            std::cerr << "ERROR::RESIDENCY::Failed to stream texture\n" << request.path << "\n";
+        }
+
+        std::lock_guard<std::mutex> lock(m_streamMutex);
+        m_results.push_back(result);
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class Texture;
+
+enum GpuResourceKind {
+    GPU_RESOURCE_TEXTURE = 0,
+    GPU_RESOURCE_BUFFER,
+    GPU_RESOURCE_FRAMEBUFFER,
+    GPU_RESOURCE_KIND_COUNT
+};
+
+// Accounts for every GL texture, buffer and framebuffer allocation and keeps
+// textures inside a VRAM budget. Textures idle for RESIDENCY_IDLE_FRAMES are
+// downscaled, then evicted, least recently used first. Binding a texture that
+// is not fully resident streams it back: the image is decoded on a worker
+// thread and uploaded during update() on the GL thread, a band of rows per
+// frame. ImGui's vertex buffers and GPU timer queries are not counted.
+class ResidencyManager {
+public:
+    static ResidencyManager& get();
+
+    /*
+    * Accounting (GL thread only)
+    */
+    void addBytes(GpuResourceKind kind, long long bytes);
+    long long getBytes(GpuResourceKind kind) const { return m_bytes[kind]; }
+    long long getTotalBytes() const;
+
+    // 0 disables the budget
+    void setBudgetBytes(long long budgetBytes) { m_budgetBytes = budgetBytes; }
+    long long getBudgetBytes() const { return m_budgetBytes; }
+
+    /*
+    * Texture residency (GL thread only)
+    */
+    void registerTexture(Texture* texture);
+    void unregisterTexture(Texture* texture);
+    void markUsed(const Texture* texture);
+
+    // Once per frame: uploads streamed textures and enforces the budget
+    void update();
+
+    const std::vector<Texture*>& getTextures() const { return m_textures; }
+    int getStreamingCount() const;
+
+private:
+    ResidencyManager();
+    ~ResidencyManager();
+
+    struct TextureEntry {
+        unsigned long long id;
+        unsigned long long lastUsedFrame;
+        bool streaming;
+    };
+
+    struct StreamRequest {
+        unsigned long long id;
+        std::string path;
+    };
+
+    struct StreamResult {
+        unsigned long long id;
+        unsigned char* data;
+        int width, height, channels;
+        int uploadedRows;
+    };
+
+    // Accounting
+    long long m_bytes[GPU_RESOURCE_KIND_COUNT];
+    long long m_budgetBytes;
+
+    // Textures
+    std::vector<Texture*> m_textures;
+    std::unordered_map<const Texture*, TextureEntry> m_entries;
+    unsigned long long m_nextId;
+    unsigned long long m_frame;
+    unsigned long long m_nextWarningFrame;
+    void enforceBudget();
+    Texture* findTexture(unsigned long long id);
+
+    // Decoded images waiting for upload, the front one is uploaded a band per frame
+    std::deque<StreamResult> m_uploads;
+    void uploadStreamBand();
+
+    // Streaming worker
+    std::thread m_worker;
+    std::mutex m_streamMutex;
+    std::condition_variable m_streamWake;
+    std::deque<StreamRequest> m_requests;
+    std::vector<StreamResult> m_results;
+    bool m_stopping;
+    void workerLoop();
+};
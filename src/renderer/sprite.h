@@ -14,6 +14,21 @@ struct Transform {
         glm::vec2 scl = glm::vec2(1.0f),
         float rot = 0.0f)
         : position(pos), scale(scl), rotation(rot) {}
+
+    // Model matrix rotating the unit quad about its center
+    glm::mat4 modelMatrix() const {
+        glm::mat4 model = glm::mat4(1.0f);
+
+        // First, translate the sprite to the origin (to center rotation)
+        model = glm::translate(model, glm::vec3(position, 0.0f));
+        model = glm::translate(model, glm::vec3(scale.x / 2.0f, scale.y / 2.0f, 0.0f));
+
+        // Apply transform properties
+        model = glm::rotate(model, glm::radians(rotation), glm::vec3(0.0f, 0.0f, 1.0f));
+        model = glm::translate(model, glm::vec3(-scale.x / 2.0f, -scale.y / 2.0f, 0.0f));
+        model = glm::scale(model, glm::vec3(scale, 1.0f));
+        return model;
+    }
 };
 
 struct Sprite {
@@ -1,4 +1,5 @@
 #include "sprite_renderer.h"
+#include "residency_manager.h"
 #include <glad/glad.h>
 
 SpriteRenderer::SpriteRenderer(Shader& shader, int width, int height) : m_shader(shader) {
@@ -11,6 +12,7 @@ SpriteRenderer::~SpriteRenderer() {
     // Cleanup vertex array and buffer objects
     glDeleteVertexArrays(1, &m_VAO);
     glDeleteBuffers(1, &m_VBO);
+    ResidencyManager::get().addBytes(GPU_RESOURCE_BUFFER, -(long long)sizeof(SPRITE_QUAD_VERTICES));
 }
 
 void SpriteRenderer::addSprite(Sprite* sprite) {
@@ -29,16 +31,7 @@ void SpriteRenderer::render() {
             continue; // Ignore this sprite
         }
 
-        glm::mat4 model = glm::mat4(1.0f);
-
-        // First, translate the sprite to the origin (to center rotation)
-        model = glm::translate(model, glm::vec3(sprite->transform.position, 0.0f));
-        model = glm::translate(model, glm::vec3(sprite->transform.scale.x / 2.0f, sprite->transform.scale.y / 2.0f, 0.0f));
-
-        // Apply transform properties
-        model = glm::rotate(model, glm::radians(sprite->transform.rotation), glm::vec3(0.0f, 0.0f, 1.0f));
-        model = glm::translate(model, glm::vec3(-sprite->transform.scale.x / 2.0f, -sprite->transform.scale.y / 2.0f, 0.0f));
-        model = glm::scale(model, glm::vec3(sprite->transform.scale, 1.0f));
+        glm::mat4 model = sprite->transform.modelMatrix();
 
         m_shader.setMat4("projection", m_projection);
         m_shader.setMat4("model", model);
@@ -50,6 +43,14 @@ void SpriteRenderer::render() {
     glBindVertexArray(0);
 }
 
+void SpriteRenderer::setTextureQuality(float lodBias, bool trilinear) {
+    for (const auto& sprite : m_sprites) {
+        if (sprite && sprite->texture) {
+            sprite->texture->setSampling(lodBias, trilinear);
+        }
+    }
+}
+
 void SpriteRenderer::initRenderer() {
     // Enable transparency
     glEnable(GL_BLEND);
@@ -60,25 +61,14 @@ void SpriteRenderer::initRenderer() {
     glViewport(0, 0, m_viewportWidth, m_viewportHeight);
     m_projection = glm::ortho(0.0f, (float)m_viewportWidth, (float)m_viewportHeight, 0.0f, -1.0f, 1.0f);
 
-    // Quad to draw textures on
-    float vertices[] = {
-        // Pos      // Tex
-        0.0f, 1.0f,  0.0f, 1.0f,
-        1.0f, 0.0f,  1.0f, 0.0f,
-        0.0f, 0.0f,  0.0f, 0.0f,
-
-        0.0f, 1.0f,  0.0f, 1.0f,
-        1.0f, 1.0f,  1.0f, 1.0f,
-        1.0f, 0.0f,  1.0f, 0.0f
-    };
-
     // Create mesh buffers
     glGenVertexArrays(1, &m_VAO);
     glGenBuffers(1, &m_VBO);
 
     glBindVertexArray(m_VAO);
     glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(SPRITE_QUAD_VERTICES), SPRITE_QUAD_VERTICES, GL_STATIC_DRAW);
+    ResidencyManager::get().addBytes(GPU_RESOURCE_BUFFER, sizeof(SPRITE_QUAD_VERTICES));
 
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
@@ -8,6 +8,18 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+// Quad to draw textures on, shared with the fleet renderer
+static const float SPRITE_QUAD_VERTICES[] = {
+    // Pos      // Tex
+    0.0f, 1.0f,  0.0f, 1.0f,
+    1.0f, 0.0f,  1.0f, 0.0f,
+    0.0f, 0.0f,  0.0f, 0.0f,
+
+    0.0f, 1.0f,  0.0f, 1.0f,
+    1.0f, 1.0f,  1.0f, 1.0f,
+    1.0f, 0.0f,  1.0f, 0.0f
+};
+
 class SpriteRenderer {
 public:
     SpriteRenderer(Shader& shader, int width, int height);
@@ -16,6 +28,9 @@ public:
     void addSprite(Sprite* sprite);
     void render();
 
+    // Applies sampling quality to every sprite texture
+    void setTextureQuality(float lodBias, bool trilinear);
+
 private:
     // Rendering
     std::vector<Sprite*> m_sprites;
@@ -2,35 +2,66 @@
 #include <stb/stb_image.h>
 
 #include "texture.h"
+#include "residency_manager.h"
 #include <iostream>
+#include <vector>
 
-Texture::Texture(const std::string& path) {
-    glGenTextures(1, &m_ID);
-    glBindTexture(GL_TEXTURE_2D, m_ID);
+/*
+* Residency
+*/
+#define TEXTURE_MIN_DOWNSCALED_PX 128
 
-    // Wrapping mode (change to GL_REPEAT if tiling is needed)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+static int bytesPerPixel(GLenum format) {
+    return format == GL_RGBA ? 4 : 3;
+}
 
-    // Filtering (Choose based on style: smooth vs. pixelated)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+// Drivers pad RGB texels to 4 bytes in GPU memory
+#define TEXTURE_STORED_PIXEL_BYTES 4
 
-    unsigned char* data = stbi_load(path.c_str(), &m_Width, &m_Height, &m_Channels, 0);
+// Bytes of a full mip chain
+static long long mipChainBytes(int width, int height, int pixelBytes) {
+    long long bytes = 0;
+    while (true) {
+        bytes += (long long)width * height * pixelBytes;
+        if (width == 1 && height == 1) {
+            return bytes;
+        }
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+}
+
+Texture::Texture(const std::string& path)
+    : m_Width(0), m_Height(0), m_Channels(0), m_LodBias(0.0f), m_Trilinear(true),
+      m_Path(path), m_Residency(TEXTURE_EVICTED), m_Bytes(0),
+      m_StagingID(0), m_StagingWidth(0), m_StagingHeight(0), m_StagingChannels(0), m_StagingBytes(0) {
+    glGenTextures(1, &m_ID);
+    applyParameters(m_ID);
+
+    int width, height, channels;
+    unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 0);
     if (data) {
-        GLenum format = (m_Channels == 4) ? GL_RGBA : GL_RGB;
-        glTexImage2D(GL_TEXTURE_2D, 0, format, m_Width, m_Height, 0, format, GL_UNSIGNED_BYTE, data);
+        upload(data, width, height, channels);
         stbi_image_free(data);
     } else {
         std::cerr << "ERROR::TEXTURE::Failed to load texture\n" << path << "\n";
+        m_Residency = TEXTURE_FAILED;
     }
+
+    ResidencyManager::get().registerTexture(this);
 }
 
 Texture::~Texture() {
+    ResidencyManager::get().unregisterTexture(this);
+    ResidencyManager::get().addBytes(GPU_RESOURCE_TEXTURE, -(m_Bytes + m_StagingBytes));
     glDeleteTextures(1, &m_ID);
+    if (m_StagingID) {
+        glDeleteTextures(1, &m_StagingID);
+    }
 }
 
 void Texture::bind(unsigned int unit) const {
+    ResidencyManager::get().markUsed(this);
     glActiveTexture(GL_TEXTURE0 + unit);
     glBindTexture(GL_TEXTURE_2D, m_ID);
 }
@@ -39,3 +70,135 @@ void Texture::unbind(unsigned int unit) const {
     glActiveTexture(GL_TEXTURE0 + unit);
     glBindTexture(GL_TEXTURE_2D, 0);
 }
+
+/*
+* Sampling quality
+*/
+void Texture::setSampling(float lodBias, bool trilinear) {
+    m_LodBias = lodBias;
+    m_Trilinear = trilinear;
+    applyParameters(m_ID);
+    if (m_StagingID) {
+        applyParameters(m_StagingID);
+    }
+}
+
+void Texture::applyParameters(unsigned int id) const {
+    glBindTexture(GL_TEXTURE_2D, id);
+
+    // Wrapping mode (change to GL_REPEAT if tiling is needed)
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    // Filtering (Choose based on style: smooth vs. pixelated)
+    // Assets are far larger than the indicator on screen, so minify through mipmaps
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_Trilinear ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_LOD_BIAS, m_LodBias);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+/*
+* Residency
+*/
+bool Texture::downscale() {
+    if (m_Residency == TEXTURE_EVICTED || m_Residency == TEXTURE_FAILED || m_Width / 2 < TEXTURE_MIN_DOWNSCALED_PX || m_Height / 2 < TEXTURE_MIN_DOWNSCALED_PX) {
+        return false;
+    }
+
+    // Mip level 1 already holds the half resolution image
+    GLenum format = (m_Channels == 4) ? GL_RGBA : GL_RGB;
+    int width = m_Width / 2;
+    int height = m_Height / 2;
+    std::vector<unsigned char> data((size_t)width * height * bytesPerPixel(format));
+
+    glBindTexture(GL_TEXTURE_2D, m_ID);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glGetTexImage(GL_TEXTURE_2D, 1, format, GL_UNSIGNED_BYTE, data.data());
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+    allocate(data.data(), width, height, format);
+    m_Residency = TEXTURE_DOWNSCALED;
+    return true;
+}
+
+void Texture::evict() {
+    const unsigned char transparent[4] = { 0, 0, 0, 0 };
+    allocate(transparent, 1, 1, GL_RGBA);
+    m_Residency = TEXTURE_EVICTED;
+}
+
+void Texture::upload(const unsigned char* data, int width, int height, int channels) {
+    m_Channels = channels;
+    allocate(data, width, height, (m_Channels == 4) ? GL_RGBA : GL_RGB);
+    m_Residency = TEXTURE_RESIDENT;
+}
+
+void Texture::allocate(const unsigned char* data, int width, int height, GLenum format) {
+    glBindTexture(GL_TEXTURE_2D, m_ID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    long long bytes = mipChainBytes(width, height, TEXTURE_STORED_PIXEL_BYTES);
+    ResidencyManager::get().addBytes(GPU_RESOURCE_TEXTURE, bytes - m_Bytes);
+    m_Bytes = bytes;
+    m_Width = width;
+    m_Height = height;
+}
+
+/*
+* Streaming
+*/
+void Texture::beginStream(int width, int height, int channels) {
+    if (!m_StagingID) {
+        glGenTextures(1, &m_StagingID);
+        applyParameters(m_StagingID);
+    }
+
+    // Level 0 only, finishStream() generates the rest of the chain
+    GLenum format = (channels == 4) ? GL_RGBA : GL_RGB;
+    glBindTexture(GL_TEXTURE_2D, m_StagingID);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    long long bytes = mipChainBytes(width, height, TEXTURE_STORED_PIXEL_BYTES);
+    ResidencyManager::get().addBytes(GPU_RESOURCE_TEXTURE, bytes - m_StagingBytes);
+    m_StagingBytes = bytes;
+    m_StagingWidth = width;
+    m_StagingHeight = height;
+    m_StagingChannels = channels;
+}
+
+void Texture::streamRows(const unsigned char* data, int firstRow, int rowCount) {
+    GLenum format = (m_StagingChannels == 4) ? GL_RGBA : GL_RGB;
+    size_t rowBytes = (size_t)m_StagingWidth * m_StagingChannels;
+
+    glBindTexture(GL_TEXTURE_2D, m_StagingID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, firstRow, m_StagingWidth, rowCount, format, GL_UNSIGNED_BYTE, data + firstRow * rowBytes);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void Texture::finishStream() {
+    glBindTexture(GL_TEXTURE_2D, m_StagingID);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // The staging texture becomes the resident one
+    glDeleteTextures(1, &m_ID);
+    ResidencyManager::get().addBytes(GPU_RESOURCE_TEXTURE, -m_Bytes);
+    m_ID = m_StagingID;
+    m_Bytes = m_StagingBytes;
+    m_Width = m_StagingWidth;
+    m_Height = m_StagingHeight;
+    m_Channels = m_StagingChannels;
+    m_Residency = TEXTURE_RESIDENT;
+
+    m_StagingID = 0;
+    m_StagingBytes = 0;
+}
@@ -3,6 +3,14 @@
 #include <glad/glad.h>
 #include <string>
 
+// How much of a texture currently occupies GPU memory
+enum TextureResidency {
+    TEXTURE_RESIDENT = 0,  // Full resolution
+    TEXTURE_DOWNSCALED,    // Reduced resolution, full resolution streams back on use
+    TEXTURE_EVICTED,       // 1x1 transparent placeholder
+    TEXTURE_FAILED         // The image could not be loaded, keeps what it holds and is never streamed
+};
+
 class Texture {
 public:
     Texture(const std::string& path);
@@ -11,7 +19,44 @@ public:
     void bind(unsigned int unit = 0) const;
     void unbind(unsigned int unit = 0) const;
 
+    // Positive bias samples smaller mip levels, trilinear blends between them
+    void setSampling(float lodBias, bool trilinear);
+
+    /*
+    * Residency (GL thread only, driven by ResidencyManager)
+    */
+    bool downscale();  // Halves the resident resolution, false once at the minimum size
+    void evict();
+    void markFailed() { m_Residency = TEXTURE_FAILED; }
+    void upload(const unsigned char* data, int width, int height, int channels);
+
+    // Streams a full resolution image into a staging texture over several calls
+    // to streamRows(), finishStream() swaps it in with its mip chain
+    void beginStream(int width, int height, int channels);
+    void streamRows(const unsigned char* data, int firstRow, int rowCount);
+    void finishStream();
+
+    const std::string& getPath() const { return m_Path; }
+    TextureResidency getResidency() const { return m_Residency; }
+    long long getBytes() const { return m_Bytes; }
+    int getWidth() const { return m_Width; }
+    int getHeight() const { return m_Height; }
+
 private:
     unsigned int m_ID;
     int m_Width, m_Height, m_Channels;
+    float m_LodBias;
+    bool m_Trilinear;
+    void applyParameters(unsigned int id) const;
+
+    // Residency
+    std::string m_Path;
+    TextureResidency m_Residency;
+    long long m_Bytes;
+    void allocate(const unsigned char* data, int width, int height, GLenum format);
+
+    // Stream in progress
+    unsigned int m_StagingID;
+    int m_StagingWidth, m_StagingHeight, m_StagingChannels;
+    long long m_StagingBytes;
 };
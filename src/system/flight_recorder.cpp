@@ -0,0 +1,249 @@
+#include "flight_recorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <map>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static uint32_t fnv1a(const void* data, size_t size, uint32_t hash = 2166136261u) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void syncFile(std::FILE* file) {
+    std::fflush(file);
+#ifdef _WIN32
+    _commit(_fileno(file));
+#else
+    fsync(fileno(file));
+#endif
+}
+
+template <typename Clock>
+static uint64_t clockNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+FlightRecorder::FlightRecorder(const std::string& directory, size_t ringCapacity)
+    : m_head(0), m_tail(0), m_dropped(0), m_written(0), m_stopping(false),
+      m_directory(directory), m_file(nullptr), m_fileIndex(0), m_fileOffset(0), m_sequence(0) {
+    // Round up to a power of two so the ring index is a mask
+    size_t capacity = 1;
+    while (capacity < ringCapacity) {
+        capacity <<= 1;
+    }
+    m_ring.resize(capacity);
+    m_mask = capacity - 1;
+}
+
+FlightRecorder::~FlightRecorder() {
+    stop();
+}
+
+void FlightRecorder::start() {
+    if (m_writer.joinable()) {
+        return;
+    }
+
+    m_stopping = false;
+    m_writer = std::thread(&FlightRecorder::writerLoop, this);
+}
+
+void FlightRecorder::stop() {
+    if (!m_writer.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_writer.join();
+
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+/*
+* Writer thread
+*/
+void FlightRecorder::writerLoop() {
+    // Preallocating writes the whole file, keep it off the render thread.
+    // Without a file the ring is still drained and the records are discarded.
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    beginSession();
+    if (!openNextFile()) {
+        std::cerr << "Flight recorder disabled" << "\n";
+    }
+
+    std::vector<FlightRecord> batch;
+    batch.reserve(m_ring.size());
+
+    bool stopping = false;
+    while (!stopping) {
+        {
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wake.wait_for(lock, std::chrono::milliseconds(RECORDER_FLUSH_INTERVAL_MS), [this] { return m_stopping; });
+            stopping = m_stopping;
+        }
+
+        // Drain everything appended so far
+        uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        uint64_t head = m_head.load(std::memory_order_acquire);
+        batch.clear();
+        for (uint64_t i = tail; i < head; ++i) {
+            batch.push_back(m_ring[i & m_mask]);
+        }
+        m_tail.store(head, std::memory_order_release);
+
+        // Group commit in bounded blocks
+        for (size_t offset = 0; offset < batch.size(); offset += RECORDER_BLOCK_RECORDS) {
+            size_t count = std::min(batch.size() - offset, (size_t)RECORDER_BLOCK_RECORDS);
+            commitBlock(batch.data() + offset, (uint32_t)count);
+        }
+    }
+}
+
+void FlightRecorder::commitBlock(const FlightRecord* records, uint32_t count) {
+    if (!m_file) {
+        return;
+    }
+
+    size_t recordBytes = count * sizeof(FlightRecord);
+    if (m_fileOffset + (long)(sizeof(FlightBlockHeader) + recordBytes) > RECORDER_FILE_BYTES) {
+        if (!openNextFile()) {
+            return;
+        }
+    }
+
+    FlightBlockHeader header = {};
+    header.magic = RECORDER_BLOCK_MAGIC;
+    header.recordCount = count;
+    header.sequence = m_sequence++;
+    header.steadyNs = clockNs<std::chrono::steady_clock>();
+    header.wallClockNs = clockNs<std::chrono::system_clock>();
+    header.checksum = fnv1a(records, recordBytes, fnv1a(&header.sequence, sizeof(header.sequence)));
+
+    std::fseek(m_file, m_fileOffset, SEEK_SET);
+    std::fwrite(&header, sizeof(header), 1, m_file);
+    std::fwrite(records, sizeof(FlightRecord), count, m_file);
+    syncFile(m_file);
+
+    m_fileOffset += (long)(sizeof(header) + recordBytes);
+    m_written.fetch_add(count, std::memory_order_relaxed);
+}
+
+/*
+* Files
+*/
+static std::string sessionFilePath(const std::string& directory, const std::string& session, unsigned int index) {
+    return directory + "/flight_" + session + "_" + std::to_string(index) + ".rec";
+}
+
+void FlightRecorder::beginSession() {
+    // Each run gets its own set of rotated files so a restart never overwrites a crash
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    unsigned long long session = (unsigned long long)std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+    while (std::filesystem::exists(sessionFilePath(m_directory, std::to_string(session), 0))) {
+        session++;
+    }
+    m_session = std::to_string(session);
+    m_fileIndex = 0;
+
+    // Group the files on disk by session, names are flight_<session>_<index>.rec
+    std::map<unsigned long long, std::vector<std::filesystem::path>> sessions;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(m_directory, error)) {
+        std::string name = entry.path().filename().string();
+        size_t split = name.rfind('_');
+        if (name.compare(0, 7, "flight_") != 0 || entry.path().extension() != ".rec" || split <= 7) {
+            continue;
+        }
+        sessions[std::strtoull(name.c_str() + 7, nullptr, 10)].push_back(entry.path());
+    }
+
+    // Oldest first, leaving room for the new session
+    while (sessions.size() >= RECORDER_SESSION_COUNT) {
+        for (const std::filesystem::path& path : sessions.begin()->second) {
+            std::filesystem::remove(path, error);
+        }
+        sessions.erase(sessions.begin());
+    }
+}
+
+bool FlightRecorder::openNextFile() {
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+
+    std::string path = sessionFilePath(m_directory, m_session, m_fileIndex);
+    m_fileIndex = (m_fileIndex + 1) % RECORDER_FILE_COUNT;
+
+    m_file = std::fopen(path.c_str(), "wb+");
+    if (!m_file) {
+        std::cerr << "ERROR::RECORDER::FILE_NOT_OPENED: " << path << "\n";
+        return false;
+    }
+
+    // Preallocate with zeros, a zero magic marks the end of the committed blocks
+    std::vector<char> zeros(64 * 1024, 0);
+    for (long written = 0; written < RECORDER_FILE_BYTES; written += (long)zeros.size()) {
+        std::fwrite(zeros.data(), 1, zeros.size(), m_file);
+    }
+    syncFile(m_file);
+
+    m_fileOffset = 0;
+    return true;
+}
+
+/*
+* Reading
+*/
+size_t readFlightFile(const std::string& path, std::vector<FlightRecord>& records) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        std::cerr << "ERROR::RECORDER::FILE_NOT_READ: " << path << "\n";
+        return 0;
+    }
+
+    size_t blocks = 0;
+    uint64_t sequence = 0;
+    std::vector<FlightRecord> block;
+    FlightBlockHeader header;
+    while (std::fread(&header, sizeof(header), 1, file) == 1) {
+        // A zero magic is the preallocated tail, anything else invalid is a torn or damaged block
+        if (header.magic != RECORDER_BLOCK_MAGIC || header.recordCount == 0 || header.recordCount > RECORDER_BLOCK_RECORDS ||
+            (blocks > 0 && header.sequence != sequence + 1)) {
+            break;
+        }
+
+        block.resize(header.recordCount);
+        if (std::fread(block.data(), sizeof(FlightRecord), block.size(), file) != block.size() ||
+            fnv1a(block.data(), block.size() * sizeof(FlightRecord), fnv1a(&header.sequence, sizeof(header.sequence))) != header.checksum) {
+            break;
+        }
+
+        records.insert(records.end(), block.begin(), block.end());
+        sequence = header.sequence;
+        blocks++;
+    }
+
+    std::fclose(file);
+    return blocks;
+}
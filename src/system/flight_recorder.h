@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+* Recorder Properties
+*/
+#define RECORDER_RING_CAPACITY 8192        // Records, power of two (~2 minutes at 60 Hz)
+#define RECORDER_FILE_BYTES (4 * 1024 * 1024)
+#define RECORDER_FILE_COUNT 4              // Files rotated per session
+#define RECORDER_SESSION_COUNT 4           // Sessions kept on disk, the oldest are deleted at start
+#define RECORDER_FLUSH_INTERVAL_MS 100     // Group commit period
+#define RECORDER_BLOCK_RECORDS 1024        // Max records per committed block
+#define RECORDER_BLOCK_MAGIC 0x43455246u   // "FREC"
+
+#define RECORD_FLAG_SHOW_STATIONARY 0x1u
+#define RECORD_FLAG_NO_DATA 0x2u         // No valid attitude, the indicator showed the failure state
+#define RECORD_FLAG_SIMULATED 0x4u       // The attitude came from a simulated source
+
+// One displayed frame
+struct FlightRecord {
+    uint64_t frameIndex;
+    uint64_t timestampNs;   // Steady clock at frame start
+    float pitch;            // In Degrees
+    float roll;             // In Degrees
+    uint32_t flags;         // RECORD_FLAG_*
+    uint32_t qualityLevel;  // Frame governor level
+};
+static_assert(sizeof(FlightRecord) == 32, "FlightRecord is a fixed on-disk size");
+
+// Precedes every group of records on disk. A block is valid when the magic
+// matches, its sequence follows the previous block and the checksum covers
+// the records, so a reader stops cleanly at a torn write after a crash.
+struct FlightBlockHeader {
+    uint32_t magic;
+    uint32_t recordCount;
+    uint64_t sequence;      // Increases across files of a session
+    uint64_t steadyNs;      // Steady clock at commit, maps record timestamps
+    uint64_t wallClockNs;   // System clock at commit
+    uint32_t checksum;      // FNV-1a over the sequence and records
+    uint32_t reserved;
+};
+static_assert(sizeof(FlightBlockHeader) == 40, "FlightBlockHeader is a fixed on-disk size");
+
+// Appends the committed records of one recorder file in order and returns the
+// number of valid blocks. Stops at the first block that is unwritten, torn,
+// corrupted or out of sequence.
+size_t readFlightFile(const std::string& path, std::vector<FlightRecord>& records);
+
+// Black box recorder. The render thread appends into a lock-free single
+// producer/single consumer ring and never waits; a writer thread drains it
+// every RECORDER_FLUSH_INTERVAL_MS into preallocated files rotated per session.
+// Each start opens a new session and keeps the newest RECORDER_SESSION_COUNT,
+// so disk use stays bounded across restarts.
+class FlightRecorder {
+public:
+    FlightRecorder(const std::string& directory, size_t ringCapacity = RECORDER_RING_CAPACITY);
+    ~FlightRecorder();
+
+    // Starts the writer thread, which creates the directory, deletes the oldest
+    // sessions and opens the first file. Records appended meanwhile wait in the ring.
+    void start();
+    void stop();
+
+    // Render thread only. Returns false when the ring is full and the record was dropped.
+    bool append(const FlightRecord& record) {
+        uint64_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) >= m_ring.size()) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        m_ring[head & m_mask] = record;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    uint64_t getWrittenCount() const { return m_written.load(std::memory_order_relaxed); }
+    uint64_t getDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    // Ring, head and tail on separate cache lines
+    std::vector<FlightRecord> m_ring;
+    uint64_t m_mask;
+    alignas(64) std::atomic<uint64_t> m_head;
+    alignas(64) std::atomic<uint64_t> m_tail;
+    alignas(64) std::atomic<uint64_t> m_dropped;
+    std::atomic<uint64_t> m_written;
+
+    // Writer thread
+    std::thread m_writer;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    bool m_stopping;
+    void writerLoop();
+    void commitBlock(const FlightRecord* records, uint32_t count);
+
+    // Files
+    std::string m_directory;
+    std::string m_session;
+    std::FILE* m_file;
+    unsigned int m_fileIndex;
+    long m_fileOffset;
+    uint64_t m_sequence;
+    void beginSession();
+    bool openNextFile();
+};
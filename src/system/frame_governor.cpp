@@ -0,0 +1,95 @@
+#include "frame_governor.h"
+#include <iostream>
+
+/*
+* Governor tuning
+*/
+#define GOVERNOR_DOWNGRADE_RATIO 0.95f // Fraction of the budget that triggers a downgrade
+#define GOVERNOR_UPGRADE_RATIO 0.60f   // Fraction of the budget required to upgrade
+#define GOVERNOR_COOLDOWN_FRAMES 60    // Frames to hold a level after changing it
+
+static const QualityLevel QUALITY_LEVELS[] = {
+    { 1.00f, 0.0f, true },
+    { 0.85f, 0.5f, true },
+    { 0.70f, 1.0f, false },
+    { 0.50f, 1.5f, false },
+};
+
+static const int QUALITY_LEVEL_COUNT = sizeof(QUALITY_LEVELS) / sizeof(QUALITY_LEVELS[0]);
+
+FrameGovernor::FrameGovernor(float budgetMs)
+    : m_sampleCount(0), m_nextSample(0), m_budgetMs(budgetMs), m_level(0), m_cooldownFrames(0) {
+    m_samples.fill(0.0f);
+}
+
+bool FrameGovernor::recordFrame(float frameMs) {
+    m_samples[m_nextSample] = frameMs;
+    m_nextSample = (m_nextSample + 1) % SAMPLE_COUNT;
+    if (m_sampleCount < SAMPLE_COUNT) {
+        m_sampleCount++;
+    }
+
+    if (m_cooldownFrames > 0) {
+        m_cooldownFrames--;
+        return false;
+    }
+
+    // Wait for a full window of samples before judging a level
+    if (m_sampleCount < SAMPLE_COUNT) {
+        return false;
+    }
+
+    float averageMs = getAverageMs();
+    if (averageMs > m_budgetMs * GOVERNOR_DOWNGRADE_RATIO && m_level < QUALITY_LEVEL_COUNT - 1) {
+        changeLevel(m_level + 1, averageMs);
+        return true;
+    }
+
+    if (averageMs < m_budgetMs * GOVERNOR_UPGRADE_RATIO && m_level > 0) {
+        changeLevel(m_level - 1, averageMs);
+        return true;
+    }
+
+    return false;
+}
+
+const QualityLevel& FrameGovernor::getQuality() const {
+    return QUALITY_LEVELS[m_level];
+}
+
+int FrameGovernor::getLevelCount() const {
+    return QUALITY_LEVEL_COUNT;
+}
+
+void FrameGovernor::setBudgetMs(float budgetMs) {
+    m_budgetMs = budgetMs;
+}
+
+float FrameGovernor::getAverageMs() const {
+    if (m_sampleCount == 0) {
+        return 0.0f;
+    }
+
+    float total = 0.0f;
+    for (int i = 0; i < m_sampleCount; ++i) {
+        total += m_samples[i];
+    }
+    return total / m_sampleCount;
+}
+
+void FrameGovernor::changeLevel(int level, float averageMs) {
+    const QualityLevel& quality = QUALITY_LEVELS[level];
+    std::cout << "[FrameGovernor] " << (level > m_level ? "Downgrade" : "Upgrade")
+              << " to level " << level
+              << " (scale " << quality.renderScale
+              << ", LOD bias " << quality.lodBias
+              << ", trilinear " << (quality.trilinear ? "on" : "off")
+              << "): average " << averageMs << " ms, budget " << m_budgetMs << " ms\n";
+
+    m_level = level;
+    m_cooldownFrames = GOVERNOR_COOLDOWN_FRAMES;
+
+    // Samples from the previous level no longer describe this one
+    m_sampleCount = 0;
+    m_nextSample = 0;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+
+// Render settings the governor trades for frame time, best quality first
+struct QualityLevel {
+    float renderScale; // Offscreen resolution relative to the window
+    float lodBias;     // Texture LOD bias, positive samples smaller mips
+    bool trilinear;    // Blend between mip levels
+};
+
+// Watches recent frame times and steps the quality level up or down to stay
+// inside a millisecond budget. Hysteresis: downgrades need the average over
+// the window to exceed the budget, upgrades need it well under the budget,
+// and every change is followed by a cooldown while the new level settles.
+class FrameGovernor {
+public:
+    FrameGovernor(float budgetMs);
+
+    // Records one frame, returns true when the quality level changed
+    bool recordFrame(float frameMs);
+
+    const QualityLevel& getQuality() const;
+    int getLevel() const { return m_level; }
+    int getLevelCount() const;
+
+    float getBudgetMs() const { return m_budgetMs; }
+    void setBudgetMs(float budgetMs);
+
+    // Average over the sample window
+    float getAverageMs() const;
+
+private:
+    static const int SAMPLE_COUNT = 30;
+    std::array<float, SAMPLE_COUNT> m_samples;
+    int m_sampleCount;
+    int m_nextSample;
+
+    float m_budgetMs;
+    int m_level;
+    int m_cooldownFrames;
+
+    void changeLevel(int level, float averageMs);
+};
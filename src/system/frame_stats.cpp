@@ -0,0 +1,71 @@
+#include "frame_stats.h"
+#include "renderer/residency_manager.h"
+
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <fstream>
+#include <string>
+#endif
+
+/*
+* Stats Properties
+*/
+#define FRAME_STATS_INTERVAL 600 // Frames per summary (10 s at 60 Hz)
+
+// Taken during static initialization, before WinMain runs
+static const std::chrono::steady_clock::time_point PROCESS_START = std::chrono::steady_clock::now();
+
+// Resident set size of this process in bytes, 0 when unavailable
+static size_t residentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.WorkingSetSize;
+    }
+    return 0;
+#else
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) {
+            return std::stoull(line.substr(6)) * 1024;
+        }
+    }
+    return 0;
+#endif
+}
+
+FrameStats::FrameStats(const char* label) : m_label(label), m_frames(0), m_totalMs(0.0), m_maxMs(0.0) {}
+
+void FrameStats::markStartupComplete() {
+    double startupMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - PROCESS_START).count();
+    std::cout << "[FrameStats] " << m_label << ": startup " << startupMs << " ms, resident "
+              << residentBytes() / (1024.0 * 1024.0) << " MB\n";
+}
+
+void FrameStats::beginFrame() {
+    m_frameStart = std::chrono::steady_clock::now();
+}
+
+void FrameStats::endFrame() {
+    double frameMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_frameStart).count();
+    m_totalMs += frameMs;
+    m_maxMs = frameMs > m_maxMs ? frameMs : m_maxMs;
+
+    if (++m_frames < FRAME_STATS_INTERVAL) {
+        return;
+    }
+
+    const double mb = 1024.0 * 1024.0;
+    std::cout << "[FrameStats] " << m_label << ": CPU frame avg " << m_totalMs / m_frames
+              << " ms, max " << m_maxMs << " ms over " << m_frames << " frames, resident "
+              << residentBytes() / mb << " MB, GPU " << ResidencyManager::get().getTotalBytes() / mb << " MB\n";
+
+    m_frames = 0;
+    m_totalMs = 0.0;
+    m_maxMs = 0.0;
+}
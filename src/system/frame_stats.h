@@ -0,0 +1,23 @@
+#pragma once
+
+#include <chrono>
+
+// Logs startup time, CPU frame time and memory footprint to the console so
+// builds (developer vs kiosk) can be compared on the target hardware
+class FrameStats {
+public:
+    FrameStats(const char* label);
+
+    // Logs the time from process start to the first presented frame
+    void markStartupComplete();
+
+    void beginFrame();
+    void endFrame(); // Logs a summary every FRAME_STATS_INTERVAL frames
+
+private:
+    const char* m_label;
+    std::chrono::steady_clock::time_point m_frameStart;
+    int m_frames;
+    double m_totalMs;
+    double m_maxMs;
+};
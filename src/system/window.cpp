@@ -1,18 +1,21 @@
 #include "window.h"
+#include "renderer/residency_manager.h"
 
 // Constructor and Destructor
 Window::Window(const char *title, unsigned int width, unsigned int height)
     : title(title), width(width), height(height), m_window(nullptr) {}
 
 Window::~Window() {
+#ifndef INDICATOR_KIOSK
     cleanupImGui();
+#endif
     glfwTerminate();
 }
 
 /*
  * Initialization
  */
-bool Window::init() {
+bool Window::init(bool fullscreen) {
     if (!glfwInit()) {
         std::cerr << "Failed to initialize GLFW" << "\n";
         return false;
@@ -22,7 +25,19 @@ bool Window::init() {
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
-    m_window = glfwCreateWindow(width, height, title, NULL, NULL);
+    GLFWmonitor *monitor = NULL;
+    if (fullscreen) {
+        monitor = glfwGetPrimaryMonitor();
+        const GLFWvidmode *mode = monitor ? glfwGetVideoMode(monitor) : NULL;
+        if (mode) {
+            width = mode->width;
+            height = mode->height;
+        } else {
+            monitor = NULL;
+        }
+    }
+
+    m_window = glfwCreateWindow(width, height, title, monitor, NULL);
     if (!m_window) {
         std::cerr << "Failed to create GLFW window" << "\n";
         glfwTerminate();
@@ -40,6 +55,7 @@ bool Window::init() {
     return true;
 }
 
+#ifndef INDICATOR_KIOSK
 /*
  * ImGui Initialization and Support
  */
@@ -54,12 +70,18 @@ bool Window::initImGui() {
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
     ImGuiIO& io = ImGui::GetIO();
-    (void)io;
 
     // Setup Platform/Renderer bindings
     ImGui_ImplGlfw_InitForOpenGL(m_window, true);
     ImGui_ImplOpenGL3_Init("#version 330");
 
+    // The backend uploads the font atlas as a single RGBA texture
+    unsigned char* atlasPixels;
+    int atlasWidth, atlasHeight;
+    io.Fonts->GetTexDataAsRGBA32(&atlasPixels, &atlasWidth, &atlasHeight);
+    m_fontAtlasBytes = (long long)atlasWidth * atlasHeight * 4;
+    ResidencyManager::get().addBytes(GPU_RESOURCE_TEXTURE, m_fontAtlasBytes);
+
     // Setup Dear ImGui style
     ImGui::StyleColorsDark();
 
@@ -79,10 +101,13 @@ void Window::renderImGui() {
 
 void Window::cleanupImGui() {
     // Cleanup ImGui
+    ResidencyManager::get().addBytes(GPU_RESOURCE_TEXTURE, -m_fontAtlasBytes);
+    m_fontAtlasBytes = 0;
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
 }
+#endif
 
 /*
  * Input Handling
@@ -127,6 +152,10 @@ void Window::getSize(int &width, int &height) const {
     glfwGetWindowSize(m_window, &width, &height);
 }
 
+void Window::getFramebufferSize(int &width, int &height) const {
+    glfwGetFramebufferSize(m_window, &width, &height);
+}
+
 // Static callback for when the window is resized
 void Window::framebufferSizeCallback(GLFWwindow *window, int width, int height) {
     glViewport(0, 0, width, height);
@@ -9,10 +9,12 @@
 #undef APIENTRY
 #endif
 
-// ImGui headers
+// ImGui headers (compiled out of the kiosk build)
+#ifndef INDICATOR_KIOSK
 #include "imgui/imgui.h"
 #include "imgui/backends/imgui_impl_glfw.h"
 #include "imgui/backends/imgui_impl_opengl3.h"
+#endif
 
 class Window {
 public:
@@ -22,8 +24,10 @@ public:
     /*
      * Initialization
      */
-    bool init();
+    bool init(bool fullscreen = false); // Fullscreen uses the primary monitor's mode
+#ifndef INDICATOR_KIOSK
     bool initImGui();
+#endif
 
     /*
      * Input Handling
@@ -47,18 +51,26 @@ public:
     void setTitle(const char *newTitle);
     void resize(unsigned int newWidth, unsigned int newHeight);
     void getSize(int &width, int &height) const;
+    void getFramebufferSize(int &width, int &height) const;
 
+#ifndef INDICATOR_KIOSK
     /*
      * ImGui Support
      */
     void beginImGuiFrame();
     void renderImGui();
     void cleanupImGui();
+#endif
 
 private:
     // GLFW window object
     GLFWwindow *m_window;
 
+#ifndef INDICATOR_KIOSK
+    // ImGui font atlas, reported to the ResidencyManager
+    long long m_fontAtlasBytes = 0;
+#endif
+
     // Window settings
     const char *title;
     unsigned int width;